@@ -0,0 +1,31 @@
+# Bash completion for devcore.
+# Source this file from ~/.bashrc: source ~/.config/devcore/completions/devcore.bash
+
+_devcore()
+{
+    local cur="${COMP_WORDS[COMP_CWORD]}"
+    local context=""
+
+    if [ "$COMP_CWORD" -eq 1 ]; then
+        context="commands"
+    elif [ "$COMP_CWORD" -eq 2 ]; then
+        case "${COMP_WORDS[1]}" in
+            list|-l|list-all|-la) context="list" ;;
+            delete-lang|create-lang) context="languages" ;;
+            archive|restore|open) context="projects" ;;
+            trash) COMPREPLY=($(compgen -W "undo purge" -- "$cur")); return ;;
+            config) COMPREPLY=($(compgen -W "get set reset view" -- "$cur")); return ;;
+            devmap) COMPREPLY=($(compgen -W "reset view" -- "$cur")); return ;;
+        esac
+    elif [ "$COMP_CWORD" -eq 3 ] && [ "${COMP_WORDS[1]}" = "config" ]; then
+        case "${COMP_WORDS[2]}" in
+            get|set) context="keys" ;;
+        esac
+    fi
+
+    [ -z "$context" ] && return
+    local IFS=$'\n'
+    COMPREPLY=($(devcore __complete "$context" "$cur" 2>/dev/null))
+}
+
+complete -F _devcore devcore
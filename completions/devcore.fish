@@ -0,0 +1,16 @@
+# Fish completion for devcore.
+# Copy this file to ~/.config/fish/completions/devcore.fish
+
+function __devcore_complete
+    devcore __complete $argv[1] (commandline -ct) 2>/dev/null
+end
+
+complete -c devcore -f
+complete -c devcore -n "__fish_is_first_token" -a "(__devcore_complete commands)"
+complete -c devcore -n "__fish_seen_subcommand_from list -l list-all -la" -a "(__devcore_complete list)"
+complete -c devcore -n "__fish_seen_subcommand_from delete-lang create-lang" -a "(__devcore_complete languages)"
+complete -c devcore -n "__fish_seen_subcommand_from archive restore open" -a "(__devcore_complete projects)"
+complete -c devcore -n "__fish_seen_subcommand_from trash; and not __fish_seen_subcommand_from undo purge" -a "undo purge"
+complete -c devcore -n "__fish_seen_subcommand_from config; and not __fish_seen_subcommand_from get set reset view" -a "get set reset view"
+complete -c devcore -n "__fish_seen_subcommand_from config; and __fish_seen_subcommand_from get set" -a "(__devcore_complete keys)"
+complete -c devcore -n "__fish_seen_subcommand_from devmap" -a "reset view"
@@ -0,0 +1,26 @@
+# devcore jump for bash: `dj <fragment>...` changes to the best matching project, and changing
+# into a project folder any other way counts as a visit too.
+# Source this file from ~/.bashrc: source ~/.config/devcore/completions/jump.bash
+
+dj()
+{
+    local dir
+    # Without a fragment there is nowhere to go, show the ranking instead.
+    [ $# -eq 0 ] && { devcore jump; return; }
+    dir="$(devcore jump "$@")" || return
+    # devcore jump counted this visit already, the hook must not count it again.
+    _DEVCORE_JUMP_PWD="$dir"
+    cd "$dir"
+}
+
+_devcore_jump_hook()
+{
+    [ "$PWD" = "$_DEVCORE_JUMP_PWD" ] && return
+    _DEVCORE_JUMP_PWD="$PWD"
+    devcore jump --add "$PWD" 2>/dev/null
+}
+
+case ";$PROMPT_COMMAND;" in
+    *";_devcore_jump_hook;"*) ;;
+    *) PROMPT_COMMAND="_devcore_jump_hook${PROMPT_COMMAND:+;$PROMPT_COMMAND}" ;;
+esac
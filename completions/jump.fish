@@ -0,0 +1,21 @@
+# devcore jump for fish: `dj <fragment>...` changes to the best matching project, and changing
+# into a project folder any other way counts as a visit too.
+# Copy this file to ~/.config/fish/conf.d/devcore-jump.fish
+
+function dj
+    # Without a fragment there is nowhere to go, show the ranking instead.
+    if test (count $argv) -eq 0
+        devcore jump
+        return
+    end
+    set -l dir (devcore jump $argv); or return
+    # devcore jump counted this visit already, the hook must not count it again.
+    set -g __devcore_jump_pwd $dir
+    cd $dir
+end
+
+function __devcore_jump_hook --on-variable PWD
+    test "$PWD" = "$__devcore_jump_pwd"; and return
+    set -g __devcore_jump_pwd $PWD
+    devcore jump --add $PWD 2>/dev/null
+end
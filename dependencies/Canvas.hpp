@@ -9,9 +9,30 @@
 #include <regex>
 #include <limits>
 #include <cstdio>
+#include <stdexcept>
 
 namespace Canvas
 {
+    // Embedded mode, used when DevCore runs inside another process (include/DevCore.hpp) or runs
+    // many commands in one (`devcore batch`): errors are collected in `errors`, and where the CLI
+    // would exit or wait for input an Exit exception is thrown instead.
+    // Silent mode discards all output.
+    inline bool embedded = false;
+    inline bool silent = false;
+    inline std::vector<std::string> errors;
+
+    struct Exit : std::runtime_error
+    {
+        using std::runtime_error::runtime_error;
+    };
+
+    // Where all output goes: std::cout, or nowhere in silent mode.
+    inline std::ostream &Out()
+    {
+        static std::ostream discard(nullptr);
+        return silent ? discard : std::cout;
+    }
+
     // Extended color enumeration, including a DEFAULT for resetting styles.
     enum class Color { RED, GREEN, BLUE, CYAN, MAGENTA, YELLOW, LIGHT_GREEN, PINK, DEFAULT };
 
@@ -79,10 +100,27 @@ namespace Canvas
         return length;
     }
 
+    // The text without its ANSI escape sequences.
+    inline std::string PlainText(const std::string &text)
+    {
+        std::string plain;
+        bool in_escape = false;
+        for (char c : text)
+        {
+            if (c == '\033')
+                in_escape = true;
+            else if (!in_escape)
+                plain += c;
+            else if (c == 'm')
+                in_escape = false;
+        }
+        return plain;
+    }
+
     // Print text in a given color.
     inline void PrintColored(const std::string &text, Color color = Color::DEFAULT)
     {
-        std::cout << ColorToAnsi(color) << text << ResetColor();
+        Out() << ColorToAnsi(color) << text << ResetColor();
     }
 
     // Print text in a given color followed by a newline.
@@ -90,7 +128,7 @@ namespace Canvas
     {
         PrintColored(text, color);
         if (endl)
-            std::cout << std::endl;
+            Out() << std::endl;
     }
 
     // Print a horizontal line using a specified Unicode character.
@@ -110,7 +148,7 @@ namespace Canvas
         int titleLength = DisplayLength(title);
         int totalWidth = titleLength + padding;
         // Title line.
-        std::cout << "\033[1m" << ColorToAnsi(color)
+        Out() << "\033[1m" << ColorToAnsi(color)
                   << '*' << std::string(totalWidth, '=') << ' ' 
                   << title << ' ' << std::string(totalWidth, '=')
                   << '*' << ResetColor() << std::endl;
@@ -131,20 +169,20 @@ namespace Canvas
                 maxLength = dlen;
         }
         // Top border.
-        std::cout << ColorToAnsi(color) << "┌─" << title;
+        Out() << ColorToAnsi(color) << "┌─" << title;
         PrintLine("─", maxLength + 1 - static_cast<int>(DisplayLength(title)) + fixOffset, color);
-        std::cout << ColorToAnsi(color) << "┐" << ResetColor() << std::endl;
+        Out() << ColorToAnsi(color) << "┐" << ResetColor() << std::endl;
         // Content lines with side borders.
         for (const auto &l : lines)
         {
-            std::cout << ColorToAnsi(color) << "│ " << ResetColor();
-            std::cout << l << std::string(maxLength - DisplayLength(l), ' ') 
+            Out() << ColorToAnsi(color) << "│ " << ResetColor();
+            Out() << l << std::string(maxLength - DisplayLength(l), ' ') 
                       << ColorToAnsi(color) << " │" << ResetColor() << std::endl;
         }
         // Bottom border.
-        std::cout << ColorToAnsi(color) << "└";
+        Out() << ColorToAnsi(color) << "└";
         PrintLine("─", maxLength + 2, color);
-        std::cout << ColorToAnsi(color) << "┘" << ResetColor() << std::endl;
+        Out() << ColorToAnsi(color) << "┘" << ResetColor() << std::endl;
     }
 
     // Print a success message with a check mark.
@@ -162,6 +200,8 @@ namespace Canvas
     // Print an error message with a cross mark.
     inline void PrintError(const std::string &message)
     {
+        if (embedded)
+            errors.push_back(PlainText(message));
         PrintColoredLine(u8"✖ | " + message, Color::RED);
     }
 
@@ -169,6 +209,8 @@ namespace Canvas
     inline void PrintErrorExit(const std::string &error, int code = -1)
     {
         PrintError(error);
+        if (embedded)
+            throw Exit(PlainText(error));
         exit(code);
     }
 
@@ -181,17 +223,26 @@ namespace Canvas
     // Clear the console screen (works on Unix-like systems with ANSI support).
     inline void ClearConsole()
     {
-        std::cout << "\033[2J\033[H";
+        Out() << "\033[2J\033[H";
+    }
+
+    // Input is never read in embedded mode, there is nobody to answer.
+    inline void RequireTerminal(const std::string &prompt)
+    {
+        if (embedded)
+            throw Exit("Interactive input is not available (asked: " + PlainText(prompt) + ")");
     }
 
     inline void GetInput(const std::string &prompt, const std::string &title = "", Color color = Color::YELLOW)
     {
+        RequireTerminal(prompt);
         PrintColored(prompt, color);
         std::cin.get();
     }
 
     inline bool GetBoolInput(const std::string &prompt, const std::string &title = "", Color color = Color::YELLOW, Color titleColor = Color::CYAN)
     {
+        RequireTerminal(title.empty() ? prompt : title);
         if (!title.empty())
             PrintTitle(title, titleColor);
         
@@ -199,12 +250,13 @@ namespace Canvas
         char in = std::cin.get();
         // Flush any leftover characters (including newline)
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        std::cout << std::endl;
+        Out() << std::endl;
         return in == 'Y' || in == 'y';
     }
 
     inline std::string GetStringInput(const std::string &prompt, const std::string &title = "", Color color = Color::YELLOW, Color titleColor = Color::CYAN)
     {
+        RequireTerminal(prompt);
         if (!title.empty())
             PrintTitle(title, titleColor);
         
@@ -222,12 +274,12 @@ namespace Canvas
         if (message.empty())
         {
             PrintLine("─", width, color);
-            std::cout << std::endl;
+            Out() << std::endl;
         }
         else
         {
             int pad = (width - static_cast<int>(DisplayLength(message)) - 2) / 2;
-            std::cout << ColorToAnsi(color) << std::string(pad, ' ') 
+            Out() << ColorToAnsi(color) << std::string(pad, ' ') 
                       << " " << message << " " 
                       << std::string(pad, ' ') << ResetColor() << std::endl;
         }
@@ -251,6 +303,8 @@ namespace Canvas
         
         // Print the error message.
         PrintError(commandStr);
+        if (embedded)
+            throw Exit(commandStr);
 
         // Execute the help command and capture its output.
         std::string helpCommand = std::string(argv[0]) + " --help";
@@ -328,6 +382,10 @@ namespace Canvas
             }
         }
 
+        // The title is drawn inside the first column's top border, so that column must fit it.
+        if (cols > 0 && DisplayLength(title) > colWidths[0] + 2)
+            colWidths[0] = DisplayLength(title) - 2;
+
         // Helper lambda to repeat a string.
         auto repeat = [](const std::string &s, size_t count) {
             std::string result;
@@ -349,7 +407,7 @@ namespace Canvas
             oss << (i < cols - 1 ? "┬" : "┐");
         }
         oss << ResetColor() << std::endl;
-        std::cout << oss.str();
+        Out() << oss.str();
 
         // Header row.
         oss.str("");
@@ -362,7 +420,7 @@ namespace Canvas
             oss << std::string(pad, ' ') << " " << ColorToAnsi(color) << "│" << ResetColor();
         }
         oss << std::endl;
-        std::cout << oss.str();
+        Out() << oss.str();
 
         // Header separator.
         oss.str("");
@@ -374,7 +432,7 @@ namespace Canvas
             oss << (i < cols - 1 ? "┼" : "┤");
         }
         oss << ResetColor() << std::endl;
-        std::cout << oss.str();
+        Out() << oss.str();
 
         // Data rows.
         for (const auto &row : rows)
@@ -391,7 +449,7 @@ namespace Canvas
                 oss << std::string(pad, ' ') << " " << ColorToAnsi(color) << "│" << ResetColor();
             }
             oss << std::endl;
-            std::cout << oss.str();
+            Out() << oss.str();
         }
 
         // Bottom border.
@@ -404,7 +462,7 @@ namespace Canvas
             oss << (i < cols - 1 ? "┴" : "┘");
         }
         oss << ResetColor() << std::endl;
-        std::cout << oss.str();
+        Out() << oss.str();
     }
 
 };
@@ -27,7 +27,11 @@ inline std::string github = "https://github.com/mathlon26/DevCore-project-manage
 
 const std::vector<std::string> validKeys{
     "projects_path",
-    "editor"
+    "editor",
+    "size_mode",
+    "exclude",
+    "trash_grace",
+    "archive_path"
 };
 
 // Utility function to trim whitespace from both ends of a string.
@@ -36,6 +40,9 @@ inline std::string trim(const std::string &s) {
     while (start != s.end() && std::isspace(*start)) {
         ++start;
     }
+    if (start == s.end()) {
+        return "";
+    }
     auto end = s.end();
     do {
         --end;
@@ -197,10 +204,12 @@ inline int setup(const std::string &filename)
     return 0;
 }
 
-void validate()
+inline void validate()
 {
     if (configMap.empty())
     {
+        if (Canvas::embedded)
+            Canvas::PrintErrorExit("No configuration loaded, '" + configFilename + "' is missing or empty.");
         setup(configFilename);
         exit(0);
     }
@@ -221,6 +230,37 @@ inline std::string get(const std::string &key) {
     return ""; // Unreachable, but added to satisfy the return type.
 }
 
+// Retrieve a configuration value by key without reporting anything.
+// Returns false if the key is not set or the configuration is not loaded.
+inline bool tryGet(const std::string &key, std::string &value) {
+    auto it = configMap.find(key);
+    if (it == configMap.end())
+        return false;
+    value = it->second;
+    return true;
+}
+
+// Retrieve an optional configuration value by key, falling back when it is not set.
+inline std::string getOr(const std::string &key, const std::string &fallback) {
+    validate();
+    auto it = configMap.find(key);
+    return it != configMap.end() ? it->second : fallback;
+}
+
+// Retrieve a comma separated configuration value as a list of trimmed, non-empty items.
+// e.g. "projects_path = /Coding/Projects/, /Storage/Projects/"
+inline std::vector<std::string> getList(const std::string &key) {
+    std::vector<std::string> items;
+    std::istringstream iss(get(key));
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        if (item.find_first_not_of(" \t") == std::string::npos)
+            continue;
+        items.push_back(trim(item));
+    }
+    return items;
+}
+
 // Set a configuration value by key and update the configuration file.
 // If the key is not among the validKeys, print an error and exit.
 inline void set(const std::string &key, const std::string &value) {
@@ -0,0 +1,124 @@
+#ifndef ARCHIVE_HPP
+#define ARCHIVE_HPP
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+namespace fs = std::filesystem;
+
+// Streaming project archives: `tar | zstd -T0` and back.
+// Both tools run as a pipeline of child processes connected by a pipe, so memory use stays at a
+// couple of pipe buffers whatever the project size, and no path ever passes through a shell.
+namespace Archive
+{
+    const std::string EXTENSION = ".tar.zst";
+
+    // Run the commands as a pipeline (stdout of one into stdin of the next).
+    // Returns true if every command exited with status 0.
+    inline bool RunPipeline(const std::vector<std::vector<std::string>> &commands, std::string &error)
+    {
+        std::vector<pid_t> children;
+        int input = -1;
+        for (size_t i = 0; i < commands.size(); i++)
+        {
+            int fds[2] = {-1, -1};
+            bool last = i + 1 == commands.size();
+            if (!last && pipe(fds) != 0)
+            {
+                error = "pipe: " + std::string(std::strerror(errno));
+                break;
+            }
+
+            pid_t pid = fork();
+            if (pid == 0)
+            {
+                if (input >= 0)
+                {
+                    dup2(input, STDIN_FILENO);
+                    close(input);
+                }
+                if (!last)
+                {
+                    dup2(fds[1], STDOUT_FILENO);
+                    close(fds[0]);
+                    close(fds[1]);
+                }
+                std::vector<char *> argv;
+                for (const auto &arg : commands[i])
+                    argv.push_back(const_cast<char *>(arg.c_str()));
+                argv.push_back(nullptr);
+                execvp(argv[0], argv.data());
+                _exit(127);
+            }
+
+            if (input >= 0)
+                close(input);
+            if (!last)
+            {
+                close(fds[1]);
+                input = fds[0];
+            }
+            if (pid < 0)
+            {
+                error = "fork: " + std::string(std::strerror(errno));
+                if (!last)
+                    close(fds[0]);
+                break;
+            }
+            children.push_back(pid);
+        }
+
+        bool ok = error.empty();
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            int status = 0;
+            while (waitpid(children[i], &status, 0) < 0 && errno == EINTR)
+                ;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            {
+                if (ok)
+                    error = "'" + commands[i][0] + "' failed" + (WIFEXITED(status) && WEXITSTATUS(status) == 127 ? " (is it installed?)" : "");
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    // Compress a directory into `archive`. The archive is written next to its final name and
+    // renamed into place, so a failed run never leaves a truncated archive behind.
+    inline bool Pack(const fs::path &directory, const fs::path &archive, std::string &error)
+    {
+        std::error_code ec;
+        fs::create_directories(archive.parent_path(), ec);
+        fs::path partial = archive.string() + ".partial";
+        if (!RunPipeline({{"tar", "-C", directory.parent_path().string(), "-cf", "-", "--", directory.filename().string()},
+                          {"zstd", "-q", "-f", "-T0", "-o", partial.string()}},
+                         error))
+        {
+            fs::remove(partial, ec);
+            return false;
+        }
+        if (rename(partial.c_str(), archive.c_str()) != 0)
+        {
+            error = std::strerror(errno);
+            fs::remove(partial, ec);
+            return false;
+        }
+        return true;
+    }
+
+    // Extract an archive made by Pack into `parent` (which must exist).
+    inline bool Unpack(const fs::path &archive, const fs::path &parent, std::string &error)
+    {
+        return RunPipeline({{"zstd", "-q", "-d", "-c", "-T0", "--", archive.string()},
+                            {"tar", "-C", parent.string(), "-xf", "-"}},
+                           error);
+    }
+} // namespace Archive
+
+#endif // ARCHIVE_HPP
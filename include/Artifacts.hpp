@@ -0,0 +1,162 @@
+#ifndef ARTIFACTS_HPP
+#define ARTIFACTS_HPP
+
+#include "Scanner.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+
+// Build artifacts per language, used by `devcore clean`.
+// A rule is a glob matched against entry names at any depth of a project. A rule with a trailing
+// '/' only matches directories, any other rule only regular files, so a source folder such as
+// `conf.d/` is never taken for a depfile, and a trailing '!' limits a rule to executable files.
+// A leading '/' limits a rule to the top level of the project. "{{project_folder}}" stands
+// for the project's folder name. Matching directories are removed as a whole and never descended into.
+namespace Artifacts
+{
+    const std::string PROJECT_FOLDER = "{{project_folder}}";
+
+    const std::map<std::string, std::vector<std::string>> rules{
+        {"C", {"build/", "obj/", "*.o", "*.d", "*.out"}},
+        // The ConsoleApp template links {{project_folder}} plus -debug and -lto variants.
+        {"C++", {"build/", "obj/", "/{{project_folder}}!", "/{{project_folder}}-debug!", "/{{project_folder}}-lto!", "*.o", "*.d", "*.gch"}},
+        {"Java", {"target/", "out/", "*.class"}},
+        {"Python", {"__pycache__/", ".pytest_cache/", ".mypy_cache/", "build/", "dist/", "*.egg-info/", "*.pyc"}},
+        {"Rust", {"target/"}},
+        {"JavaScript", {"node_modules/", "dist/"}},
+        {"TypeScript", {"node_modules/", "dist/"}},
+        {"Go", {"bin/"}},
+    };
+
+    // The rules of a language for one project, with its folder name filled in.
+    inline std::vector<std::string> RulesFor(const std::string &lang, const fs::path &projectPath)
+    {
+        auto rule = rules.find(lang);
+        if (rule == rules.end())
+            return {};
+        // The folder name is matched literally, glob characters in it are escaped.
+        std::string folder;
+        for (char c : projectPath.filename().string())
+        {
+            if (c == '*' || c == '?' || c == '[' || c == ']' || c == '\\')
+                folder += '\\';
+            folder += c;
+        }
+        std::vector<std::string> globs = rule->second;
+        for (auto &glob : globs)
+        {
+            size_t at = glob.find(PROJECT_FOLDER);
+            if (at != std::string::npos)
+                glob.replace(at, PROJECT_FOLDER.size(), folder);
+        }
+        return globs;
+    }
+
+    // Whether an entry is an artifact, `topLevel` if it sits directly in the project folder.
+    inline bool Matches(const std::vector<std::string> &globs, const char *name, mode_t mode, bool topLevel)
+    {
+        for (const auto &glob : globs)
+        {
+            bool dirOnly = !glob.empty() && glob.back() == '/';
+            bool execOnly = !glob.empty() && glob.back() == '!';
+            bool anchored = !glob.empty() && glob.front() == '/';
+            if ((dirOnly ? !S_ISDIR(mode) : !S_ISREG(mode)) || (execOnly && !(mode & S_IXUSR)) || (anchored && !topLevel))
+                continue;
+            std::string pattern = glob.substr(anchored, glob.size() - anchored - dirOnly - execOnly);
+            if (fnmatch(pattern.c_str(), name, 0) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Walk a project, opening directories relative to it with openat so symlinks are never
+    // followed. The top-level .git folder is skipped, and with `excludes` set so is anything the
+    // scanner excludes. Every other entry is passed to `visit(relPath, name, st, topLevel)`, which
+    // returns whether to descend into it.
+    template <typename Visit>
+    inline void Walk(const fs::path &projectPath, bool excludes, Visit visit)
+    {
+        int rootFd = open(projectPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (rootFd < 0)
+            return;
+
+        std::vector<std::string> stack{""};
+        while (!stack.empty())
+        {
+            std::string dir = std::move(stack.back());
+            stack.pop_back();
+
+            int fd = dir.empty() ? dup(rootFd) : openat(rootFd, dir.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (fd < 0)
+                continue;
+            DIR *handle = fdopendir(fd);
+            if (!handle)
+            {
+                close(fd);
+                continue;
+            }
+
+            while (struct dirent *entry = readdir(handle))
+            {
+                const char *name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    continue;
+                if (dir.empty() && std::strcmp(name, ".git") == 0)
+                    continue;
+                std::string relPath = dir.empty() ? std::string(name) : dir + "/" + name;
+                if (excludes && Scanner::IsExcluded(relPath, name))
+                    continue;
+
+                struct stat st;
+                if (fstatat(dirfd(handle), name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                    continue;
+                if (visit(relPath, name, st, dir.empty()) && S_ISDIR(st.st_mode))
+                    stack.push_back(relPath);
+            }
+            closedir(handle);
+        }
+
+        close(rootFd);
+    }
+
+    // Walk the sources of a project: `visit(relPath, name, st)` is called for every entry that is
+    // not a directory and not a build artifact of the project's language.
+    template <typename Visit>
+    inline void WalkSources(const fs::path &projectPath, const std::string &lang, Visit visit)
+    {
+        std::vector<std::string> rule = RulesFor(lang, projectPath);
+        Walk(projectPath, true, [&](const std::string &relPath, const char *name, const struct stat &st, bool topLevel) {
+            bool isDir = S_ISDIR(st.st_mode);
+            if (Matches(rule, name, st.st_mode, topLevel))
+                return false;
+            if (!isDir)
+                visit(relPath, name, st);
+            return isDir;
+        });
+    }
+
+    // Paths (relative to the project) of every artifact in a project. Scanner excludes are
+    // searched too, `exclude = build` must not hide build/ from clean.
+    inline std::vector<std::string> Find(const fs::path &projectPath, const std::string &lang)
+    {
+        std::vector<std::string> found;
+        std::vector<std::string> rule = RulesFor(lang, projectPath);
+        if (rule.empty())
+            return found;
+        Walk(projectPath, false, [&](const std::string &relPath, const char *name, const struct stat &st, bool topLevel) {
+            if (!Matches(rule, name, st.st_mode, topLevel))
+                return true;
+            found.push_back(relPath);
+            return false;
+        });
+        return found;
+    }
+} // namespace Artifacts
+
+#endif // ARTIFACTS_HPP
@@ -0,0 +1,76 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <string>
+#include <vector>
+#include <cctype>
+
+// Command lines for `devcore batch`.
+namespace Batch
+{
+    // Split a command line into words the way a shell would for simple commands: whitespace
+    // separates words, single quotes keep everything literal, double quotes and backslashes
+    // escape. An unquoted '#' starting a word comments out the rest of the line.
+    // A leading "devcore" is dropped, so lines can be copied from a shell script as they are.
+    // Returns false with `error` set for an unterminated quote.
+    inline bool Split(const std::string &line, std::vector<std::string> &words, std::string &error)
+    {
+        words.clear();
+        std::string word;
+        bool inWord = false;
+        char quote = 0;
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            char c = line[i];
+            if (quote == '\'')
+            {
+                if (c == '\'')
+                    quote = 0;
+                else
+                    word += c;
+            }
+            else if (quote == '"')
+            {
+                if (c == '"')
+                    quote = 0;
+                else if (c == '\\' && i + 1 < line.size() && (line[i + 1] == '"' || line[i + 1] == '\\'))
+                    word += line[++i];
+                else
+                    word += c;
+            }
+            else if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                if (inWord)
+                    words.push_back(word);
+                word.clear();
+                inWord = false;
+            }
+            else if (c == '#' && !inWord)
+            {
+                break;
+            }
+            else
+            {
+                inWord = true;
+                if (c == '\'' || c == '"')
+                    quote = c;
+                else if (c == '\\' && i + 1 < line.size())
+                    word += line[++i];
+                else
+                    word += c;
+            }
+        }
+        if (quote != 0)
+        {
+            error = std::string("Unterminated ") + (quote == '\'' ? "single" : "double") + " quote.";
+            return false;
+        }
+        if (inWord)
+            words.push_back(word);
+        if (!words.empty() && words.front() == "devcore")
+            words.erase(words.begin());
+        return true;
+    }
+} // namespace Batch
+
+#endif // BATCH_HPP
@@ -0,0 +1,214 @@
+#ifndef BUILD_HPP
+#define BUILD_HPP
+
+#include "Scanner.hpp"
+#include "Artifacts.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+extern char **environ;
+
+// Project builds for `devcore build`.
+// Every project's make joins one GNU make jobserver: a pipe preloaded with N-1 tokens, where a
+// job may only start while holding one. The Nth job is the implicit slot every make gets for
+// free, so devcore hands its single implicit slot to one project and makes every other project
+// take a token before it may start. The number of compilers running never exceeds N, however
+// many projects build at once.
+namespace Build
+{
+    class Jobserver
+    {
+    public:
+        // Create the pipe and fill it with jobs - 1 tokens.
+        bool Open(size_t jobs, std::string &error)
+        {
+            this->jobs = std::max<size_t>(1, jobs);
+            int fds[2];
+            // Not close-on-exec, every make has to inherit both ends.
+            if (pipe(fds) != 0)
+            {
+                error = "pipe: " + std::string(std::strerror(errno));
+                return false;
+            }
+            readFd = fds[0];
+            writeFd = fds[1];
+            for (size_t i = 1; i < this->jobs; i++)
+                Release();
+            return true;
+        }
+
+        void Close()
+        {
+            if (readFd >= 0)
+                close(readFd);
+            if (writeFd >= 0)
+                close(writeFd);
+            readFd = writeFd = -1;
+        }
+
+        // Block until a token is free.
+        void Acquire()
+        {
+            char token;
+            while (read(readFd, &token, 1) != 1)
+            {
+                if (errno != EINTR)
+                    return;
+            }
+        }
+
+        void Release()
+        {
+            char token = '+';
+            while (write(writeFd, &token, 1) != 1 && errno == EINTR)
+                ;
+        }
+
+        // MAKEFLAGS that make a child make join this jobserver instead of starting its own.
+        std::string MakeFlags() const
+        {
+            return "-j" + std::to_string(jobs) + " --jobserver-auth=" + std::to_string(readFd) + "," + std::to_string(writeFd);
+        }
+
+    private:
+        size_t jobs = 1;
+        int readFd = -1;
+        int writeFd = -1;
+    };
+
+    struct Result
+    {
+        bool ok = false;
+        std::string error; // Why make did not run or what it exited with.
+        double seconds = 0;
+    };
+
+    // Whether a project has a Makefile at its top level.
+    inline bool HasMakefile(const fs::path &projectPath)
+    {
+        for (const char *name : {"GNUmakefile", "makefile", "Makefile"})
+        {
+            if (fs::is_regular_file(projectPath / name))
+                return true;
+        }
+        return false;
+    }
+
+    // Newest modification time of any source file of a project.
+    inline time_t NewestSource(const fs::path &projectPath, const std::string &lang)
+    {
+        time_t newest = 0;
+        Artifacts::WalkSources(projectPath, lang, [&](const std::string &, const char *, const struct stat &st) {
+            if (st.st_mtime > newest)
+                newest = st.st_mtime;
+        });
+        return newest;
+    }
+
+    // Run make in a project with its output going to `logPath`.
+    // The caller must hold a job slot for it (the implicit slot or a token).
+    inline Result RunMake(const fs::path &projectPath, const Jobserver &jobserver, const fs::path &logPath)
+    {
+        Result result;
+        auto start = std::chrono::steady_clock::now();
+
+        // Everything the child needs is prepared before the fork, the parent has other threads
+        // running and only async-signal-safe calls are allowed between fork and exec.
+        std::string makeFlags = "MAKEFLAGS=" + jobserver.MakeFlags();
+        std::vector<char *> env;
+        for (char **var = environ; *var; var++)
+        {
+            if (std::strncmp(*var, "MAKEFLAGS=", 10) != 0 && std::strncmp(*var, "MFLAGS=", 7) != 0 && std::strncmp(*var, "MAKELEVEL=", 10) != 0)
+                env.push_back(*var);
+        }
+        env.push_back(const_cast<char *>(makeFlags.c_str()));
+        env.push_back(nullptr);
+        char make[] = "make";
+        char *argv[] = {make, nullptr};
+
+        std::error_code ec;
+        fs::create_directories(logPath.parent_path(), ec);
+        int logFd = open(logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        int nullFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (logFd < 0 || nullFd < 0)
+        {
+            result.error = "Cannot write build log '" + logPath.string() + "': " + std::strerror(errno);
+            if (logFd >= 0)
+                close(logFd);
+            if (nullFd >= 0)
+                close(nullFd);
+            return result;
+        }
+
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            dup2(nullFd, STDIN_FILENO);
+            dup2(logFd, STDOUT_FILENO);
+            dup2(logFd, STDERR_FILENO);
+            if (chdir(projectPath.c_str()) != 0)
+                _exit(126);
+            execvpe(argv[0], argv, env.data());
+            _exit(127);
+        }
+        close(logFd);
+        close(nullFd);
+        if (pid < 0)
+        {
+            result.error = "fork: " + std::string(std::strerror(errno));
+            return result;
+        }
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+            ;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            result.ok = true;
+        else if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+            result.error = "'make' could not be started (is it installed?)";
+        else if (WIFEXITED(status))
+            result.error = "make exited with status " + std::to_string(WEXITSTATUS(status));
+        else
+            result.error = "make was killed by signal " + std::to_string(WTERMSIG(status));
+        return result;
+    }
+
+    // "4.2s" or "3m 07s".
+    inline std::string Duration(double seconds)
+    {
+        char buffer[32];
+        if (seconds < 60)
+            std::snprintf(buffer, sizeof(buffer), "%.1fs", seconds);
+        else
+            std::snprintf(buffer, sizeof(buffer), "%dm %02ds", static_cast<int>(seconds) / 60, static_cast<int>(seconds) % 60);
+        return buffer;
+    }
+
+    // The last `count` lines of a build log.
+    inline std::vector<std::string> Tail(const fs::path &logPath, size_t count)
+    {
+        std::deque<std::string> lines;
+        std::ifstream file(logPath);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            lines.push_back(line);
+            if (lines.size() > count)
+                lines.pop_front();
+        }
+        return {lines.begin(), lines.end()};
+    }
+} // namespace Build
+
+#endif // BUILD_HPP
@@ -0,0 +1,98 @@
+#ifndef COMPLETE_HPP
+#define COMPLETE_HPP
+
+#include "../dependencies/Config.hpp"
+#include "Main.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+// Shell completion endpoint: `devcore __complete <context> <prefix>`.
+// Runs before the config and the DevMap are loaded and never touches the projects roots,
+// it only reads the name index that DevMap::save() keeps up to date.
+namespace Complete
+{
+    const std::vector<std::string> commands{
+        "--help", "add-template", "archive", "batch", "build", "clean", "config", "create-lang", "create-project", "dedupe", "delete-lang",
+        "delete-project", "deps", "devmap", "du", "github", "jump", "list", "list-all", "open", "remove-template", "restore", "similar", "stats", "trash", "update", "watch"
+    };
+
+    const std::vector<std::string> listTargets{"languages", "projects", "templates", "users"};
+
+    // Print every candidate that starts with prefix, candidates must already be sorted.
+    inline void PrintMatches(const std::vector<std::string_view> &candidates, std::string_view prefix)
+    {
+        auto it = std::lower_bound(candidates.begin(), candidates.end(), prefix);
+        std::string out;
+        for (; it != candidates.end() && it->substr(0, prefix.size()) == prefix; ++it)
+        {
+            out.append(it->data(), it->size());
+            out.push_back('\n');
+        }
+        fwrite(out.data(), 1, out.size(), stdout);
+    }
+
+    // Read the sorted name index and return the names of one kind ('p', 'l' or 't').
+    // The buffer owns the file contents the returned views point into.
+    inline std::vector<std::string_view> ReadIndex(char kind, std::string &buffer)
+    {
+        std::vector<std::string_view> names;
+        FILE *file = fopen((Main::HOME_PATH + Main::INDEX_PATH).c_str(), "rb");
+        if (!file)
+            return names;
+        char chunk[8192];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+            buffer.append(chunk, n);
+        fclose(file);
+
+        std::string_view data(buffer);
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            size_t end = data.find('\n', pos);
+            if (end == std::string_view::npos)
+                end = data.size();
+            if (end - pos > 2 && data[pos] == kind && data[pos + 1] == '\t')
+                names.push_back(data.substr(pos + 2, end - pos - 2));
+            pos = end + 1;
+        }
+        return names;
+    }
+
+    inline int Run(int argc, char const *argv[])
+    {
+        if (argc < 3)
+            return 1;
+        std::string context = argv[2];
+        std::string_view prefix = argc > 3 ? argv[3] : "";
+
+        auto fromList = [&](const std::vector<std::string> &list) {
+            std::vector<std::string> sorted = list;
+            std::sort(sorted.begin(), sorted.end());
+            std::vector<std::string_view> views(sorted.begin(), sorted.end());
+            PrintMatches(views, prefix);
+        };
+
+        std::string buffer;
+        if (context == "commands")
+            fromList(commands);
+        else if (context == "list")
+            fromList(listTargets);
+        else if (context == "keys")
+            fromList(Config::validKeys);
+        else if (context == "projects")
+            PrintMatches(ReadIndex('p', buffer), prefix);
+        else if (context == "languages")
+            PrintMatches(ReadIndex('l', buffer), prefix);
+        else if (context == "templates")
+            PrintMatches(ReadIndex('t', buffer), prefix);
+        else
+            return 1;
+        return 0;
+    }
+} // namespace Complete
+
+#endif // COMPLETE_HPP
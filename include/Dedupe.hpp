@@ -0,0 +1,453 @@
+#ifndef DEDUPE_HPP
+#define DEDUPE_HPP
+
+#include "Hash.hpp"
+#include "Parallel.hpp"
+#include "Scanner.hpp"
+#include "FsUtil.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <tuple>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+
+// Content-addressed deduplication of identical files across projects and templates.
+// Files are narrowed down in stages so only real candidates are ever read completely:
+// same device and size, then the hash of the first 4 KiB, then the hash of the whole file,
+// and finally a byte-by-byte comparison right before a duplicate is replaced.
+// Hashes are kept in an index keyed by (device, inode, size, mtime), so a later run only
+// hashes files that are new or changed.
+namespace Dedupe
+{
+    const size_t PARTIAL_BYTES = 4096;
+    const size_t CHUNK_BYTES = 1 << 16;
+
+    struct File
+    {
+        std::string path;
+        dev_t dev = 0;
+        ino_t ino = 0;
+        uint64_t size = 0;
+        int64_t mtime = 0; // Nanoseconds.
+        nlink_t nlink = 1;
+        uint64_t partial = 0;
+        uint64_t full = 0;
+        bool hasPartial = false;
+        bool hasFull = false;
+        bool fromIndex = false; // The hashes came from the index, the file was not read yet.
+    };
+
+    // Hashes of one file version, as stored in the index.
+    struct Hashes
+    {
+        uint64_t partial = 0;
+        uint64_t full = 0;
+        bool hasFull = false;
+    };
+
+    using Key = std::tuple<uint64_t, uint64_t, uint64_t, int64_t>;
+
+    inline Key KeyOf(const File &file)
+    {
+        return Key{static_cast<uint64_t>(file.dev), static_cast<uint64_t>(file.ino), file.size, file.mtime};
+    }
+
+    // Index format, one file per line: "<dev> <ino> <size> <mtime> <partial> <full or ->".
+    inline std::map<Key, Hashes> LoadIndex(const fs::path &indexPath)
+    {
+        std::map<Key, Hashes> index;
+        FILE *file = fopen(indexPath.c_str(), "r");
+        if (!file)
+            return index;
+        char line[256];
+        while (fgets(line, sizeof(line), file))
+        {
+            unsigned long long dev, ino, size, partial;
+            long long mtime;
+            char full[32];
+            if (std::sscanf(line, "%llx %llx %llx %llx %llx %31s", &dev, &ino, &size, &mtime, &partial, full) != 6)
+                continue;
+            Hashes hashes;
+            hashes.partial = partial;
+            hashes.hasFull = full[0] != '-';
+            hashes.full = hashes.hasFull ? std::strtoull(full, nullptr, 16) : 0;
+            index[Key{dev, ino, size, mtime}] = hashes;
+        }
+        fclose(file);
+        return index;
+    }
+
+    inline void SaveIndex(const fs::path &indexPath, const std::map<Key, Hashes> &index)
+    {
+        FsUtil::WriteAtomic(indexPath, [&](FILE *file) {
+            for (const auto &entry : index)
+            {
+                char full[32] = "-";
+                if (entry.second.hasFull)
+                    std::snprintf(full, sizeof(full), "%llx", static_cast<unsigned long long>(entry.second.full));
+                std::fprintf(file, "%llx %llx %llx %llx %llx %s\n",
+                             static_cast<unsigned long long>(std::get<0>(entry.first)),
+                             static_cast<unsigned long long>(std::get<1>(entry.first)),
+                             static_cast<unsigned long long>(std::get<2>(entry.first)),
+                             static_cast<long long>(std::get<3>(entry.first)),
+                             static_cast<unsigned long long>(entry.second.partial), full);
+            }
+        });
+    }
+
+    // Hash the first `limit` bytes of a file (the whole file when limit is 0).
+    inline bool HashFile(const std::string &path, size_t limit, uint64_t &hash)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        std::vector<char> buf(limit == 0 ? CHUNK_BYTES : std::min(limit, CHUNK_BYTES));
+        hash = 0;
+        size_t total = 0;
+        ssize_t n;
+        while ((n = FsUtil::ReadFull(fd, buf.data(), buf.size())) > 0)
+        {
+            hash = Hash::Murmur64(buf.data(), static_cast<size_t>(n), hash);
+            total += static_cast<size_t>(n);
+            if (limit != 0 && total >= limit)
+                break;
+        }
+        close(fd);
+        return n >= 0;
+    }
+
+    inline bool SameContent(const std::string &a, const std::string &b)
+    {
+        int fa = open(a.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        int fb = open(b.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        bool same = fa >= 0 && fb >= 0;
+        std::vector<char> bufA(CHUNK_BYTES), bufB(CHUNK_BYTES);
+        while (same)
+        {
+            ssize_t na = FsUtil::ReadFull(fa, bufA.data(), bufA.size());
+            ssize_t nb = FsUtil::ReadFull(fb, bufB.data(), bufB.size());
+            if (na < 0 || na != nb || std::memcmp(bufA.data(), bufB.data(), static_cast<size_t>(na)) != 0)
+                same = false;
+            else if (na == 0)
+                break;
+        }
+        if (fa >= 0)
+            close(fa);
+        if (fb >= 0)
+            close(fb);
+        return same;
+    }
+
+    // Every non-empty regular file under a directory. The top-level .git folder and paths the
+    // scanner excludes are skipped.
+    inline void Collect(const fs::path &directory, std::vector<File> &files)
+    {
+        std::vector<std::string> stack{directory.string()};
+        while (!stack.empty())
+        {
+            std::string dir = std::move(stack.back());
+            stack.pop_back();
+            DIR *handle = opendir(dir.c_str());
+            if (!handle)
+                continue;
+            bool top = dir == directory.string();
+            size_t relStart = directory.string().size() + 1;
+            while (struct dirent *entry = readdir(handle))
+            {
+                const char *name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    continue;
+                if (top && std::strcmp(name, ".git") == 0)
+                    continue;
+                std::string path = dir + "/" + name;
+                if (Scanner::IsExcluded(path.substr(relStart), name))
+                    continue;
+                struct stat st;
+                if (fstatat(dirfd(handle), name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                    continue;
+                if (S_ISDIR(st.st_mode))
+                {
+                    stack.push_back(path);
+                }
+                else if (S_ISREG(st.st_mode) && st.st_size > 0)
+                {
+                    File file;
+                    file.path = path;
+                    file.dev = st.st_dev;
+                    file.ino = st.st_ino;
+                    file.size = static_cast<uint64_t>(st.st_size);
+                    file.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+                    file.nlink = st.st_nlink;
+                    files.push_back(file);
+                }
+            }
+            closedir(handle);
+        }
+    }
+
+    enum class Method
+    {
+        None,
+        Reflink,
+        Hardlink
+    };
+
+    // Replace `dup` with a copy-on-write clone of `keeper` (FICLONE), or a hard link when allowed
+    // and the two files have the same owner and mode. The new file is set up under a temporary
+    // name and renamed over the duplicate, so the duplicate path is never missing.
+    inline Method Replace(const File &keeper, const File &dup, bool allowHardlink)
+    {
+        struct stat dupStat, keepStat;
+        if (stat(dup.path.c_str(), &dupStat) != 0 || stat(keeper.path.c_str(), &keepStat) != 0)
+            return Method::None;
+        fs::path target = dup.path;
+        std::string tmp = (target.parent_path() / ("." + target.filename().string() + ".devcore-dedupe")).string();
+
+        int src = open(keeper.path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        if (src < 0)
+            return Method::None;
+        int dst = open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, dupStat.st_mode & 07777);
+        if (dst >= 0)
+        {
+            bool cloned = ioctl(dst, FICLONE, src) == 0;
+            if (cloned)
+            {
+                if (fchown(dst, dupStat.st_uid, dupStat.st_gid) != 0)
+                {
+                    // Not allowed to keep another user's ownership, keep our own.
+                }
+                struct timespec times[2] = {dupStat.st_atim, dupStat.st_mtim};
+                futimens(dst, times);
+            }
+            close(dst);
+            close(src);
+            if (cloned && rename(tmp.c_str(), dup.path.c_str()) == 0)
+                return Method::Reflink;
+            unlink(tmp.c_str());
+        }
+        else
+        {
+            close(src);
+        }
+
+        if (!allowHardlink || dupStat.st_uid != keepStat.st_uid || dupStat.st_mode != keepStat.st_mode)
+            return Method::None;
+        if (link(keeper.path.c_str(), tmp.c_str()) != 0)
+            return Method::None;
+        if (rename(tmp.c_str(), dup.path.c_str()) != 0)
+        {
+            unlink(tmp.c_str());
+            return Method::None;
+        }
+        return Method::Hardlink;
+    }
+
+    // A set of identical files, the first one is kept.
+    struct Group
+    {
+        std::vector<File> files;
+        size_t replaced = 0;
+        uint64_t saved = 0;
+    };
+
+    struct Report
+    {
+        size_t scanned = 0;    // Files found.
+        size_t candidates = 0; // Files sharing their size with another file.
+        size_t hashed = 0;     // Files that had to be read, the others were answered by the index.
+        size_t duplicates = 0; // Files identical to another file.
+        size_t reflinked = 0;
+        size_t hardlinked = 0;
+        size_t skipped = 0;    // Duplicates that could not be replaced.
+        uint64_t saved = 0;    // Bytes freed (or that would be freed in a dry run).
+        std::vector<Group> groups;
+    };
+
+    // Split `files` into groups of two or more that share the value of `key`.
+    template <typename KeyFn>
+    std::vector<std::vector<File>> SplitBy(std::vector<File> &files, KeyFn key)
+    {
+        std::map<decltype(key(files.front())), std::vector<File>> buckets;
+        for (auto &file : files)
+            buckets[key(file)].push_back(std::move(file));
+        std::vector<std::vector<File>> groups;
+        for (auto &bucket : buckets)
+        {
+            if (bucket.second.size() > 1)
+                groups.push_back(std::move(bucket.second));
+        }
+        return groups;
+    }
+
+    // Find the duplicate files under `directories` (earlier directories win as keepers) and,
+    // unless dryRun is set, replace every duplicate by a clone of its keeper.
+    inline Report Run(const std::vector<fs::path> &directories, const fs::path &indexPath, bool dryRun, bool allowHardlink)
+    {
+        Report report;
+        size_t workers = Parallel::HardwareThreads();
+
+        // 1. Collect the files of every directory in parallel, one inode counts once.
+        std::vector<std::vector<File>> perDirectory(directories.size());
+        Parallel::ForEach(directories.size(), workers, [&](size_t i) {
+            Collect(directories[i], perDirectory[i]);
+        });
+        std::vector<File> files;
+        std::set<std::pair<dev_t, ino_t>> seenInodes;
+        for (auto &dirFiles : perDirectory)
+        {
+            for (auto &file : dirFiles)
+            {
+                if (seenInodes.insert({file.dev, file.ino}).second)
+                    files.push_back(std::move(file));
+            }
+        }
+        report.scanned = files.size();
+
+        // 2. Only files that share their device and size with another file can be duplicates.
+        std::vector<std::vector<File>> sizeGroups = SplitBy(files, [](const File &f) { return std::make_pair(f.dev, f.size); });
+
+        std::map<Key, Hashes> index = LoadIndex(indexPath);
+        std::map<Key, Hashes> nextIndex;
+
+        // 3. Hash the first 4 KiB of every candidate, answered from the index when possible.
+        std::vector<File *> pending;
+        for (auto &group : sizeGroups)
+        {
+            report.candidates += group.size();
+            for (auto &file : group)
+            {
+                auto found = index.find(KeyOf(file));
+                if (found != index.end())
+                {
+                    file.partial = found->second.partial;
+                    file.hasPartial = true;
+                    file.full = found->second.full;
+                    file.hasFull = found->second.hasFull;
+                    file.fromIndex = true;
+                }
+                else
+                {
+                    pending.push_back(&file);
+                }
+            }
+        }
+        Parallel::ForEach(pending.size(), workers, [&](size_t i) {
+            File &file = *pending[i];
+            file.hasPartial = HashFile(file.path, PARTIAL_BYTES, file.partial);
+            // Small files are read completely by the partial hash already.
+            if (file.hasPartial && file.size <= PARTIAL_BYTES)
+            {
+                file.full = file.partial;
+                file.hasFull = true;
+            }
+        });
+        size_t hashed = pending.size();
+
+        // 4. Hash whole files only where the first 4 KiB collide.
+        std::vector<std::vector<File>> partialGroups;
+        for (auto &group : sizeGroups)
+        {
+            group.erase(std::remove_if(group.begin(), group.end(), [](const File &f) { return !f.hasPartial; }), group.end());
+            for (const auto &file : group)
+                nextIndex[KeyOf(file)] = {file.partial, file.full, file.hasFull};
+            for (auto &sub : SplitBy(group, [](const File &f) { return f.partial; }))
+                partialGroups.push_back(std::move(sub));
+        }
+        pending.clear();
+        for (auto &group : partialGroups)
+        {
+            for (auto &file : group)
+            {
+                if (file.hasFull)
+                    continue;
+                pending.push_back(&file);
+                if (file.fromIndex)
+                    hashed++;
+            }
+        }
+        Parallel::ForEach(pending.size(), workers, [&](size_t i) {
+            File &file = *pending[i];
+            file.hasFull = HashFile(file.path, 0, file.full);
+        });
+        report.hashed = hashed;
+
+        for (auto &group : partialGroups)
+        {
+            for (const auto &file : group)
+                nextIndex[KeyOf(file)] = {file.partial, file.full, file.hasFull};
+            group.erase(std::remove_if(group.begin(), group.end(), [](const File &f) { return !f.hasFull; }), group.end());
+            for (auto &sub : SplitBy(group, [](const File &f) { return f.full; }))
+            {
+                // Keep the file from the earliest directory, SplitBy preserves the collection order.
+                report.groups.push_back({std::move(sub), 0, 0});
+            }
+        }
+
+        // 5. Compare and replace, one group per task.
+        std::vector<std::vector<std::pair<Key, Hashes>>> newEntries(report.groups.size());
+        std::atomic<size_t> reflinked{0}, hardlinked{0}, skipped{0};
+        Parallel::ForEach(report.groups.size(), workers, [&](size_t g) {
+            Group &group = report.groups[g];
+            const File &keeper = group.files.front();
+            for (size_t i = 1; i < group.files.size(); i++)
+            {
+                const File &dup = group.files[i];
+                // Data shared with other hard links stays allocated.
+                uint64_t freed = dup.nlink <= 1 ? dup.size : 0;
+                if (dryRun)
+                {
+                    group.replaced++;
+                    group.saved += freed;
+                    continue;
+                }
+                Method method = SameContent(keeper.path, dup.path) ? Replace(keeper, dup, allowHardlink) : Method::None;
+                if (method == Method::None)
+                {
+                    skipped++;
+                    continue;
+                }
+                (method == Method::Reflink ? reflinked : hardlinked)++;
+                group.replaced++;
+                group.saved += freed;
+
+                // The replaced file is a new inode (or the keeper's), remember its hashes too.
+                struct stat st;
+                if (stat(dup.path.c_str(), &st) == 0)
+                {
+                    File now = dup;
+                    now.ino = st.st_ino;
+                    now.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+                    newEntries[g].push_back({KeyOf(now), {dup.partial, dup.full, true}});
+                }
+            }
+        });
+        for (const auto &entries : newEntries)
+            nextIndex.insert(entries.begin(), entries.end());
+        report.reflinked = reflinked;
+        report.hardlinked = hardlinked;
+        report.skipped = skipped;
+        for (const auto &group : report.groups)
+        {
+            report.duplicates += group.files.size() - 1;
+            report.saved += group.saved;
+        }
+
+        // Files that vanished or changed drop out of the index, it only holds what was seen now.
+        SaveIndex(indexPath, nextIndex);
+        return report;
+    }
+} // namespace Dedupe
+
+#endif // DEDUPE_HPP
@@ -0,0 +1,454 @@
+#ifndef DEPS_HPP
+#define DEPS_HPP
+
+#include "Scanner.hpp"
+#include "Artifacts.hpp"
+#include "Parallel.hpp"
+#include "FsUtil.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <deque>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <nlohmann/json.hpp>
+
+// Include graph of the C and C++ projects, for `devcore deps`.
+// Every source and header is mapped and its #include lines are read straight from the mapping.
+// The directives of each file are cached by path, size and mtime, so a later run only parses
+// files that changed. Includes are resolved like the ConsoleApp layout expects: quoted ones
+// next to the including file first, then against the project's include/, dependencies/ and its
+// root. Anything that does not resolve inside the project is an external header.
+namespace Deps
+{
+    const std::set<std::string> SOURCE_EXTENSIONS{".c", ".cc", ".cpp", ".cxx", ".c++"};
+    const std::set<std::string> HEADER_EXTENSIONS{".h", ".hh", ".hpp", ".hxx", ".h++", ".inl", ".ipp", ".tpp"};
+    // Directories of a project that includes are resolved against, besides the project root.
+    const std::vector<std::string> INCLUDE_DIRS{"include", "dependencies"};
+
+    // Languages whose projects are part of the graph.
+    inline bool IsCLanguage(const std::string &lang)
+    {
+        std::string lower;
+        for (char c : lang)
+            lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return lower == "c" || lower == "c++" || lower == "cpp" || lower == "cxx";
+    }
+
+    struct Include
+    {
+        std::string spelling; // What is between the quotes or angle brackets.
+        bool angled = false;
+    };
+
+    struct File
+    {
+        size_t project = 0;
+        std::string relPath; // Relative to the project.
+        std::string path;
+        int64_t mtime = 0; // Nanoseconds.
+        uint64_t size = 0;
+        bool source = false;
+        std::vector<Include> includes;
+    };
+
+    struct ProjectInput
+    {
+        std::string name;
+        fs::path path;
+        std::string lang;
+    };
+
+    // Whether a file takes part in the graph. Extensionless files count as headers inside the
+    // include directories, the Canvas headers of the ConsoleApp template have no extension.
+    inline bool Classify(const std::string &relPath, const char *name, bool &source)
+    {
+        const char *dot = std::strrchr(name, '.');
+        std::string extension = dot ? dot : "";
+        source = SOURCE_EXTENSIONS.count(extension) > 0;
+        if (source || HEADER_EXTENSIONS.count(extension) > 0)
+            return true;
+        if (dot != nullptr)
+            return false;
+        for (const auto &dir : INCLUDE_DIRS)
+        {
+            if (relPath.compare(0, dir.size() + 1, dir + "/") == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Every source and header of a project.
+    inline std::vector<File> ListFiles(size_t project, const fs::path &projectPath, const std::string &lang)
+    {
+        std::vector<File> files;
+        Artifacts::WalkSources(projectPath, lang, [&](const std::string &relPath, const char *name, const struct stat &st) {
+            File file;
+            if (!S_ISREG(st.st_mode) || !Classify(relPath, name, file.source))
+                return;
+            file.project = project;
+            file.relPath = relPath;
+            file.path = (projectPath / relPath).string();
+            file.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+            file.size = static_cast<uint64_t>(st.st_size);
+            files.push_back(std::move(file));
+        });
+        return files;
+    }
+
+    // The #include directives in a buffer. Only lines whose first token is '#' are looked at,
+    // the scan jumps from newline to newline with memchr.
+    inline std::vector<Include> ParseIncludes(const char *data, size_t size)
+    {
+        std::vector<Include> includes;
+        const char *end = data + size;
+        const char *line = data;
+        while (line < end)
+        {
+            const char *next = static_cast<const char *>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+            const char *lineEnd = next ? next : end;
+
+            const char *p = line;
+            while (p < lineEnd && (*p == ' ' || *p == '\t'))
+                p++;
+            if (p < lineEnd && *p == '#')
+            {
+                p++;
+                while (p < lineEnd && (*p == ' ' || *p == '\t'))
+                    p++;
+                if (lineEnd - p > 7 && std::memcmp(p, "include", 7) == 0)
+                {
+                    p += 7;
+                    while (p < lineEnd && (*p == ' ' || *p == '\t'))
+                        p++;
+                    if (p < lineEnd && (*p == '"' || *p == '<'))
+                    {
+                        char close = *p == '"' ? '"' : '>';
+                        const char *start = ++p;
+                        while (p < lineEnd && *p != close)
+                            p++;
+                        if (p < lineEnd && p > start)
+                            includes.push_back({std::string(start, p), close == '>'});
+                    }
+                }
+            }
+            line = lineEnd + 1;
+        }
+        return includes;
+    }
+
+    // Map a file and read its includes.
+    inline bool ScanFile(File &file)
+    {
+        file.includes.clear();
+        if (file.size == 0)
+            return true;
+        int fd = open(file.path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        // A file truncated since the walk would fault past its new end, it is being saved and skipped.
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) != file.size)
+        {
+            close(fd);
+            return false;
+        }
+        void *data = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return false;
+        madvise(data, file.size, MADV_SEQUENTIAL);
+        file.includes = ParseIncludes(static_cast<const char *>(data), file.size);
+        munmap(data, file.size);
+        return true;
+    }
+
+    // Cached directives of one file version.
+    struct CacheEntry
+    {
+        int64_t mtime = 0;
+        uint64_t size = 0;
+        std::vector<Include> includes;
+    };
+
+    // Cache format: "F <mtime> <size> <path>" (hex numbers) for every file, followed by one
+    // "I <\" or <><spelling>" line per include of that file.
+    inline std::map<std::string, CacheEntry> LoadCache(const fs::path &cachePath)
+    {
+        std::map<std::string, CacheEntry> cache;
+        std::ifstream file(cachePath);
+        std::string line;
+        CacheEntry *current = nullptr;
+        while (std::getline(file, line))
+        {
+            if (line.size() > 3 && line.compare(0, 2, "F ") == 0)
+            {
+                unsigned long long size;
+                long long mtime;
+                int consumed = 0;
+                if (std::sscanf(line.c_str() + 2, "%llx %llx %n", &mtime, &size, &consumed) != 2 || consumed == 0)
+                {
+                    current = nullptr;
+                    continue;
+                }
+                current = &cache[line.substr(2 + consumed)];
+                current->mtime = mtime;
+                current->size = size;
+            }
+            else if (current != nullptr && line.size() > 3 && line.compare(0, 2, "I ") == 0)
+            {
+                current->includes.push_back({line.substr(3), line[2] == '<'});
+            }
+        }
+        return cache;
+    }
+
+    inline void SaveCache(const fs::path &cachePath, const std::map<std::string, CacheEntry> &cache)
+    {
+        FsUtil::WriteAtomic(cachePath, [&](FILE *file) {
+            for (const auto &[path, entry] : cache)
+            {
+                std::fprintf(file, "F %llx %llx %s\n", static_cast<long long>(entry.mtime), static_cast<unsigned long long>(entry.size), path.c_str());
+                for (const auto &include : entry.includes)
+                    std::fprintf(file, "I %c%s\n", include.angled ? '<' : '"', include.spelling.c_str());
+            }
+        });
+    }
+
+    struct Node
+    {
+        std::string id;          // "<project>:<relPath>", or "<spelling>" for external headers.
+        long project = -1;       // Index into Graph::projects, -1 for external headers.
+        std::string relPath;     // The spelling for external headers.
+        bool source = false;
+        bool external = false;
+    };
+
+    struct Graph
+    {
+        std::vector<ProjectInput> projects;
+        std::vector<Node> nodes;
+        std::vector<std::vector<size_t>> edges; // Includer -> included, per node.
+        size_t parsed = 0;                      // Files read in this run.
+        size_t cached = 0;                      // Files answered by the cache.
+    };
+
+    // Scan the projects in parallel and build their include graph. With `prune` the cache keeps
+    // only the files seen in this run, otherwise entries of other projects are kept.
+    inline Graph Build(const std::vector<ProjectInput> &projects, const fs::path &cachePath, bool prune)
+    {
+        Graph graph;
+        graph.projects = projects;
+
+        std::vector<std::vector<File>> perProject(projects.size());
+        Parallel::ForEach(projects.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            perProject[i] = ListFiles(i, projects[i].path, projects[i].lang);
+        });
+        std::vector<File> files;
+        for (auto &list : perProject)
+        {
+            for (auto &file : list)
+                files.push_back(std::move(file));
+        }
+
+        std::map<std::string, CacheEntry> cache = LoadCache(cachePath);
+        std::atomic<size_t> parsed{0};
+        Parallel::ForEach(files.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            File &file = files[i];
+            auto hit = cache.find(file.path);
+            if (hit != cache.end() && hit->second.mtime == file.mtime && hit->second.size == file.size)
+            {
+                file.includes = hit->second.includes;
+                return;
+            }
+            ScanFile(file);
+            parsed++;
+        });
+        graph.parsed = parsed;
+        graph.cached = files.size() - graph.parsed;
+        std::map<std::string, CacheEntry> updated;
+        for (const auto &file : files)
+            updated[file.path] = {file.mtime, file.size, file.includes};
+        if (!prune)
+            updated.insert(cache.begin(), cache.end());
+        if (graph.parsed > 0 || updated.size() != cache.size())
+            SaveCache(cachePath, updated);
+
+        // One node per file, then one per external header as they are found.
+        std::map<std::string, size_t> byPath;
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            Node node;
+            node.id = projects[files[i].project].name + ":" + files[i].relPath;
+            node.project = static_cast<long>(files[i].project);
+            node.relPath = files[i].relPath;
+            node.source = files[i].source;
+            graph.nodes.push_back(node);
+            byPath[fs::path(files[i].path).lexically_normal().string()] = i;
+        }
+        graph.edges.resize(files.size());
+        std::map<std::string, size_t> externals;
+
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            const File &file = files[i];
+            const fs::path &root = projects[file.project].path;
+            std::set<size_t> targets;
+            for (const auto &include : file.includes)
+            {
+                std::vector<fs::path> candidates;
+                if (!include.angled)
+                    candidates.push_back(fs::path(file.path).parent_path() / include.spelling);
+                for (const auto &dir : INCLUDE_DIRS)
+                    candidates.push_back(root / dir / include.spelling);
+                candidates.push_back(root / include.spelling);
+
+                size_t target = SIZE_MAX;
+                for (const auto &candidate : candidates)
+                {
+                    auto found = byPath.find(candidate.lexically_normal().string());
+                    if (found != byPath.end())
+                    {
+                        target = found->second;
+                        break;
+                    }
+                }
+                if (target == SIZE_MAX)
+                {
+                    auto found = externals.find(include.spelling);
+                    if (found == externals.end())
+                    {
+                        Node node;
+                        node.id = "<" + include.spelling + ">";
+                        node.relPath = include.spelling;
+                        node.external = true;
+                        graph.nodes.push_back(node);
+                        graph.edges.emplace_back();
+                        found = externals.emplace(include.spelling, graph.nodes.size() - 1).first;
+                    }
+                    target = found->second;
+                }
+                if (target != i)
+                    targets.insert(target);
+            }
+            graph.edges[i].assign(targets.begin(), targets.end());
+        }
+        return graph;
+    }
+
+    // Nodes matching a header given on the command line: a project file whose path ends with it,
+    // or an external header spelled that way ("Canvas.hpp", "include/App.h", "nlohmann/json.hpp").
+    inline std::vector<size_t> Match(const Graph &graph, const std::string &query)
+    {
+        std::vector<size_t> matches;
+        for (size_t i = 0; i < graph.nodes.size(); i++)
+        {
+            const std::string &path = graph.nodes[i].relPath;
+            if (path == query || graph.nodes[i].id == query ||
+                (path.size() > query.size() && path.compare(path.size() - query.size(), query.size(), query) == 0 && path[path.size() - query.size() - 1] == '/'))
+                matches.push_back(i);
+        }
+        return matches;
+    }
+
+    // Every node that includes one of `targets`, directly or not, with its distance to the
+    // nearest target (1 = includes it directly).
+    inline std::map<size_t, size_t> Dependents(const Graph &graph, const std::vector<size_t> &targets)
+    {
+        std::vector<std::vector<size_t>> reverse(graph.nodes.size());
+        for (size_t from = 0; from < graph.edges.size(); from++)
+        {
+            for (size_t to : graph.edges[from])
+                reverse[to].push_back(from);
+        }
+
+        std::map<size_t, size_t> depth;
+        for (size_t target : targets)
+            depth[target] = 0;
+        std::deque<size_t> queue(targets.begin(), targets.end());
+        while (!queue.empty())
+        {
+            size_t node = queue.front();
+            queue.pop_front();
+            for (size_t includer : reverse[node])
+            {
+                if (depth.emplace(includer, depth[node] + 1).second)
+                    queue.push_back(includer);
+            }
+        }
+        for (size_t target : targets)
+            depth.erase(target);
+        return depth;
+    }
+
+    inline std::string DotQuote(const std::string &text)
+    {
+        std::string quoted = "\"";
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                quoted += '\\';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    // Graphviz DOT, one cluster per project and external headers as boxes.
+    inline std::string ToDot(const Graph &graph)
+    {
+        std::ostringstream out;
+        out << "digraph deps {\n    rankdir=LR;\n    node [shape=ellipse, fontsize=10];\n";
+        for (size_t p = 0; p < graph.projects.size(); p++)
+        {
+            out << "    subgraph cluster_" << p << " {\n        label=" << DotQuote(graph.projects[p].name) << ";\n";
+            for (const auto &node : graph.nodes)
+            {
+                if (node.project == static_cast<long>(p))
+                    out << "        " << DotQuote(node.id) << " [label=" << DotQuote(node.relPath) << (node.source ? ", style=bold" : "") << "];\n";
+            }
+            out << "    }\n";
+        }
+        for (const auto &node : graph.nodes)
+        {
+            if (node.external)
+                out << "    " << DotQuote(node.id) << " [shape=box];\n";
+        }
+        for (size_t from = 0; from < graph.edges.size(); from++)
+        {
+            for (size_t to : graph.edges[from])
+                out << "    " << DotQuote(graph.nodes[from].id) << " -> " << DotQuote(graph.nodes[to].id) << ";\n";
+        }
+        out << "}\n";
+        return out.str();
+    }
+
+    // JSON with the projects, the nodes and the edges as [from, to] node indices.
+    inline nlohmann::json ToJson(const Graph &graph)
+    {
+        nlohmann::json json = {{"projects", nlohmann::json::array()}, {"nodes", nlohmann::json::array()}, {"edges", nlohmann::json::array()}};
+        for (const auto &project : graph.projects)
+            json["projects"].push_back({{"name", project.name}, {"path", project.path.string()}});
+        for (const auto &node : graph.nodes)
+        {
+            nlohmann::json entry = {{"id", node.id}, {"file", node.relPath}, {"kind", node.external ? "external" : node.source ? "source" : "header"}};
+            entry["project"] = node.project < 0 ? nlohmann::json() : nlohmann::json(graph.projects[node.project].name);
+            json["nodes"].push_back(entry);
+        }
+        for (size_t from = 0; from < graph.edges.size(); from++)
+        {
+            for (size_t to : graph.edges[from])
+                json["edges"].push_back({from, to});
+        }
+        return json;
+    }
+} // namespace Deps
+
+#endif // DEPS_HPP
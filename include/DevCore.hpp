@@ -0,0 +1,258 @@
+#ifndef DEVCORE_HPP
+#define DEVCORE_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "../dependencies/Config.hpp"
+#include "DevMap.hpp"
+#include "Lock.hpp"
+#include "Main.hpp"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <exception>
+
+// DevCore as a library: the project, language, template and config operations of the CLI as
+// plain calls, for editor plugins and services that want them without starting a process.
+// Everything is header-only like the rest of DevCore, include this header and build with
+// -std=c++17 -pthread.
+//
+//     if (auto opened = DevCore::Open(); !opened)
+//         log(opened.error);
+//     for (const auto &project : DevCore::Projects().value)
+//         ...
+//
+// Calls never print, prompt or exit the process, failures come back in Result::error.
+// They are serialized by a mutex, so any thread may call them. Every call first catches up
+// with changes other devcore processes made to the DevMap, a long-lived host never works
+// on a stale view.
+namespace DevCore
+{
+    // The value of a call, or why it failed.
+    template <typename T>
+    struct Result
+    {
+        T value{};
+        std::string error; // Empty on success.
+
+        bool ok() const { return error.empty(); }
+        explicit operator bool() const { return ok(); }
+    };
+
+    // Result of a call without a value.
+    using Status = Result<bool>;
+
+    namespace Detail
+    {
+        inline std::mutex mutex;
+        inline bool opened = false;
+
+        inline std::string Joined(const std::vector<std::string> &messages, const std::string &fallback)
+        {
+            std::string joined;
+            for (const auto &message : messages)
+                joined += (joined.empty() ? "" : "\n") + message;
+            return joined.empty() ? fallback : joined;
+        }
+
+        // Run fn(value) embedded and silent. fn returns false on failure, after reporting why with
+        // Canvas::PrintError, or throws (PrintErrorExit throws Canvas::Exit when embedded).
+        template <typename T, typename Fn>
+        Result<T> Call(bool catchUp, Fn fn)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Result<T> result;
+            bool wasEmbedded = Canvas::embedded, wasSilent = Canvas::silent;
+            Canvas::embedded = Canvas::silent = true;
+            Trash::purgeInProcess = true; // The host has threads of its own, it is never forked.
+            Canvas::errors.clear();
+            try
+            {
+                if (catchUp && !opened)
+                    Canvas::PrintErrorExit("DevCore is not opened, call DevCore::Open() first.");
+                if (catchUp)
+                {
+                    Lock::Guard guard(DevMap::LockPath(), true);
+                    DevMap::Refresh();
+                    DevMap::loadCached();
+                }
+                if (!fn(result.value))
+                    result.error = Joined(Canvas::errors, "The operation failed.");
+            }
+            catch (const std::exception &e)
+            {
+                result.error = Joined(Canvas::errors, e.what());
+            }
+            Canvas::errors.clear();
+            Canvas::embedded = wasEmbedded;
+            Canvas::silent = wasSilent;
+            return result;
+        }
+    } // namespace Detail
+
+    // Load the config and the DevMap from ~/.config/devcore. With `sync` the projects roots are
+    // scanned like the CLI does, without it the DevMap is used as it was last written.
+    inline Status Open(bool sync = true)
+    {
+        return Detail::Call<bool>(false, [&](bool &value) {
+            Detail::opened = false;
+            Config::configMap.clear();
+            if (!Config::load(Main::HOME_PATH + Main::CONFIG_PATH))
+                Canvas::PrintErrorExit("No configuration at '" + Main::HOME_PATH + Main::CONFIG_PATH + "', run devcore once to set it up.");
+            if (!DevMap::load(Main::HOME_PATH + Main::DEVMAP_PATH, false, sync))
+                Canvas::PrintErrorExit("No DevMap at '" + Main::HOME_PATH + Main::DEVMAP_PATH + "', run devcore once to set it up.");
+            return value = Detail::opened = true;
+        });
+    }
+
+    // Rescan the projects roots: new and removed projects, sizes and activity.
+    inline Status Sync()
+    {
+        return Detail::Call<bool>(true, [](bool &value) {
+            DevMap::syncDevMap();
+            return value = true;
+        });
+    }
+
+    // ---- Projects ----
+
+    inline Result<std::vector<DevMap::Project>> Projects()
+    {
+        return Detail::Call<std::vector<DevMap::Project>>(true, [](std::vector<DevMap::Project> &value) {
+            value = DevMap::projects;
+            return true;
+        });
+    }
+
+    inline Result<DevMap::Project> FindProject(const std::string &name)
+    {
+        return Detail::Call<DevMap::Project>(true, [&](DevMap::Project &value) {
+            const DevMap::Project *project = DevMap::findProjectByName(DevMap::projects, name);
+            if (project == nullptr)
+                Canvas::PrintErrorExit("No project named '" + name + "'.");
+            value = *project;
+            return true;
+        });
+    }
+
+    // Create projects, all or none (see `devcore create-project --manifest`).
+    inline Status CreateProjects(const std::vector<DevMap::ProjectSpec> &specs)
+    {
+        return Detail::Call<bool>(true, [&](bool &value) {
+            return value = DevMap::CreateProjects(specs);
+        });
+    }
+
+    inline Result<DevMap::Project> CreateProject(const DevMap::ProjectSpec &spec)
+    {
+        return Detail::Call<DevMap::Project>(true, [&](DevMap::Project &value) {
+            if (!DevMap::CreateProjects({spec}))
+                return false;
+            value = DevMap::projects.back();
+            return true;
+        });
+    }
+
+    // Move a project to the trash. The value is the trash id for UndoDelete, empty if the
+    // project could not be trashed and was deleted in place.
+    inline Result<std::string> DeleteProject(const std::string &name)
+    {
+        return Detail::Call<std::string>(true, [&](std::string &value) {
+            return DevMap::DeleteProject(name, value);
+        });
+    }
+
+    // Restore a deleted project by trash id or project name.
+    inline Status UndoDelete(const std::string &idOrName)
+    {
+        return Detail::Call<bool>(true, [&](bool &value) {
+            return value = DevMap::UndoTrash(idOrName);
+        });
+    }
+
+    inline Status ArchiveProject(const std::string &name)
+    {
+        return Detail::Call<bool>(true, [&](bool &value) {
+            return value = DevMap::ArchiveProject(name);
+        });
+    }
+
+    inline Status RestoreProject(const std::string &name)
+    {
+        return Detail::Call<bool>(true, [&](bool &value) {
+            return value = DevMap::RestoreProject(name);
+        });
+    }
+
+    // ---- Languages ----
+
+    inline Result<std::vector<std::string>> Languages()
+    {
+        return Detail::Call<std::vector<std::string>>(true, [](std::vector<std::string> &value) {
+            value = DevMap::languages;
+            return true;
+        });
+    }
+
+    inline Status CreateLanguage(const std::string &lang)
+    {
+        return Detail::Call<bool>(true, [&](bool &value) {
+            return value = DevMap::CreateLang(lang);
+        });
+    }
+
+    // Delete a language, its directories must be empty.
+    inline Status DeleteLanguage(const std::string &lang)
+    {
+        return Detail::Call<bool>(true, [&](bool &value) {
+            return value = DevMap::DeleteLanguage(lang);
+        });
+    }
+
+    // ---- Templates ----
+
+    // Every template as "<lang>/<name>".
+    inline Result<std::vector<std::string>> Templates()
+    {
+        return Detail::Call<std::vector<std::string>>(true, [](std::vector<std::string> &value) {
+            value = DevMap::TemplateNames();
+            return true;
+        });
+    }
+
+    // Copy a directory into the templates, creating the language if needed.
+    inline Status AddTemplate(const std::string &lang, const std::string &name, const std::string &source)
+    {
+        return Detail::Call<bool>(true, [&](bool &value) {
+            return value = DevMap::AddTemplate(name, lang, source);
+        });
+    }
+
+    inline Status RemoveTemplate(const std::string &lang, const std::string &name)
+    {
+        return Detail::Call<bool>(true, [&](bool &value) {
+            return value = DevMap::RemoveTemplate(lang + "/" + name);
+        });
+    }
+
+    // ---- Config ----
+
+    inline Result<std::string> GetConfig(const std::string &key)
+    {
+        return Detail::Call<std::string>(false, [&](std::string &value) {
+            if (!Config::tryGet(key, value))
+                Canvas::PrintErrorExit("Config key '" + key + "' is not set.");
+            return true;
+        });
+    }
+
+    // Set a config key and write it to devcore.conf.
+    inline Status SetConfig(const std::string &key, const std::string &value)
+    {
+        return Detail::Call<bool>(false, [&](bool &result) {
+            Config::set(key, value);
+            return result = true;
+        });
+    }
+} // namespace DevCore
+
+#endif // DEVCORE_HPP
@@ -4,6 +4,23 @@
 #include "../dependencies/Canvas.hpp"
 #include "../dependencies/Config.hpp"
 #include "Main.hpp"
+#include "Scanner.hpp"
+#include "Parallel.hpp"
+#include "Journal.hpp"
+#include "Lock.hpp"
+#include "FsUtil.hpp"
+#include "Artifacts.hpp"
+#include "Trash.hpp"
+#include "Archive.hpp"
+#include "Dedupe.hpp"
+#include "Template.hpp"
+#include "Build.hpp"
+#include "Deps.hpp"
+#include "Stats.hpp"
+#include "Similar.hpp"
+#include "Screen.hpp"
+#include "Watch.hpp"
+#include "Jump.hpp"
 #include <string>
 #include <filesystem>
 #include <fstream>
@@ -11,9 +28,15 @@
 #include <iomanip>
 #include <vector>
 #include <set>
+#include <map>
 #include <ctime>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <poll.h>
 #include <nlohmann/json.hpp>
 #ifdef _WIN32
 #include <windows.h>
@@ -34,18 +57,46 @@ namespace DevMap
         std::string createdBy;  // User who created the project.
         time_t createdAt;       // Creation time.
         size_t size;            // Project size in bytes.
+        size_t gitSize = 0;     // Bytes inside the .git folder (included in size).
         bool usesGit;           // Wether there is a .git folder in the projects
+        time_t lastActivity = 0; // Newest file modification time seen by the last scan.
+        time_t lastBuild = 0;   // When the last successful `devcore build` started, 0 if never.
+        fs::path root;          // Projects root this project lives under.
+        bool archived = false;  // Packed into an archive, the project directory does not exist.
+        fs::path archive;       // The archive file of an archived project.
+        size_t files = 0;       // Files counted by the last `devcore stats`, 0 if never counted.
+        size_t lines = 0;       // Lines in those files.
+        std::map<std::string, Stats::Count> fileTypes; // The same counts by file type.
     };
 
+    // Version of the DevMap layout written by this build, stored as "Version". Version 1 (no
+    // "Version" key) kept created_at as "HH:MM DD-MM-YYYY" text, version 2 stores epoch seconds.
+    const int SCHEMA_VERSION = 2;
+    // Version of the name index layout, see WriteNameIndex.
+    const int NAME_INDEX_VERSION = 2;
+
     // Global inline variables to store the DevMap state.
-    inline fs::path projectsPath;
+    inline fs::path projectsPath;             // Primary projects root, new languages and projects are created here.
+    inline std::vector<fs::path> projectRoots; // Every configured projects root, primary first.
     inline fs::path devmapFileName;
     inline nlohmann::json devmapData;
     inline std::vector<std::string> languages;
     inline std::set<std::string> users;
     inline std::vector<Project> projects;
 
-    const Project* findProjectByName(const std::vector<Project>& projects, const std::string& name) {
+    // What this process has seen of the DevMap on disk, used to merge in changes made by other
+    // devcore processes before writing: the snapshot's inode (it changes on every compaction),
+    // how far into the journal we have replayed, and the generation of the last applied change.
+    inline ino_t snapshotInode = 0;
+    inline size_t journalOffset = 0;
+    inline uint64_t generation = 0;
+
+    // While set, Commit only applies records in memory and queues them, Flush writes them all at
+    // once. Used by `devcore batch` to write the DevMap a single time for a whole script.
+    inline bool deferCommits = false;
+    inline std::vector<nlohmann::json> deferred;
+
+    inline const Project* findProjectByName(const std::vector<Project>& projects, const std::string& name) {
         auto it = std::find_if(projects.begin(), projects.end(), [&name](const Project& project) {
             return project.name == name;
         });
@@ -57,7 +108,7 @@ namespace DevMap
         return nullptr;  // Not found
     }
 
-    std::string getCurrentUser() {
+    inline std::string getCurrentUser() {
     #ifdef _WIN32
         const char* user = std::getenv("USERNAME");
     #else
@@ -73,6 +124,7 @@ namespace DevMap
     }
 
     // Helper: Convert a time string ("HH:MM DD-MM-YYYY") to a time_t value.
+    // Only needed to migrate DevMaps from before schema version 2, which stored times this way.
     inline time_t parseTime(const std::string &timeStr)
     {
         std::tm tm = {};
@@ -85,7 +137,7 @@ namespace DevMap
         return std::mktime(&tm);
     }
 
-    // Helper: Convert a time_t value back to a formatted string.
+    // Helper: Convert a time_t value to a formatted string for display.
     inline std::string timeToString(time_t t)
     {
         std::tm *tmPtr = std::localtime(&t);
@@ -94,6 +146,40 @@ namespace DevMap
         return std::string(buffer);
     }
 
+    // Helper: Format a byte count with binary units ("512 B", "1.4 KiB", "3.0 GiB").
+    inline std::string HumanSize(size_t bytes)
+    {
+        const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB", "PiB"};
+        double value = static_cast<double>(bytes);
+        int unit = 0;
+        while (value >= 1024.0 && unit < 5)
+        {
+            value /= 1024.0;
+            unit++;
+        }
+        char buffer[32];
+        if (unit == 0)
+            std::snprintf(buffer, sizeof(buffer), "%zu B", bytes);
+        else
+            std::snprintf(buffer, sizeof(buffer), "%.1f %s", value, units[unit]);
+        return std::string(buffer);
+    }
+
+    // Helper: Format how long ago a time was ("just now", "5 min ago", "3 h ago", "12 days ago").
+    inline std::string AgeString(time_t then, time_t now)
+    {
+        if (then <= 0)
+            return "never";
+        time_t age = now > then ? now - then : 0;
+        if (age < 60)
+            return "just now";
+        if (age < 3600)
+            return std::to_string(age / 60) + " min ago";
+        if (age < 86400)
+            return std::to_string(age / 3600) + " h ago";
+        return std::to_string(age / 86400) + (age < 2 * 86400 ? " day ago" : " days ago");
+    }
+
     inline bool usesGit(const std::string &projectfolder)
     {
         fs::path gitPath = fs::path(projectfolder) / ".git";
@@ -102,24 +188,130 @@ namespace DevMap
 
     inline size_t getFolderSize(const std::string &projectfolder)
     {
-        size_t totalSize = 0;
-        fs::path folderPath(projectfolder);
-        if (fs::exists(folderPath) && fs::is_directory(folderPath))
+        return Scanner::ScanProject(projectfolder).size;
+    }
+
+    // Quote a string for safe use as a single argument in a std::system command.
+    inline std::string ShellQuote(const std::string &arg)
+    {
+        std::string quoted = "'";
+        for (char c : arg)
         {
-            for (const auto &entry : fs::recursive_directory_iterator(folderPath))
-            {
-                if (fs::is_regular_file(entry.status()))
-                {
-                    totalSize += fs::file_size(entry);
-                }
-            }
+            if (c == '\'')
+                quoted += "'\\''";
+            else
+                quoted += c;
+        }
+        return quoted + "'";
+    }
+
+    // Full path of a project on disk: <root>/<lang>/<folderName>.
+    inline fs::path ProjectPath(const Project &proj)
+    {
+        return (proj.root.empty() ? projectsPath : proj.root) / proj.lang / proj.folderName;
+    }
+
+    // JSON representation of a project as stored in the DevMap.
+    inline nlohmann::json ProjectToJson(const Project &proj)
+    {
+        nlohmann::json projData = {
+            {"name", proj.name},
+            {"folderName", proj.folderName},
+            {"lang", proj.lang},
+            {"created_by", proj.createdBy},
+            {"created_at", static_cast<int64_t>(proj.createdAt)},
+            {"size", proj.size},
+            {"git", proj.usesGit},
+            {"git_size", proj.gitSize},
+            {"last_activity", static_cast<int64_t>(proj.lastActivity)},
+            {"last_build", static_cast<int64_t>(proj.lastBuild)},
+            {"root", (proj.root.empty() ? projectsPath : proj.root).string()}
+        };
+        if (proj.archived)
+        {
+            projData["archived"] = true;
+            projData["archive"] = proj.archive.string();
+        }
+        if (proj.files > 0)
+        {
+            projData["files"] = proj.files;
+            projData["lines"] = proj.lines;
+            for (const auto &[type, count] : proj.fileTypes)
+                projData["file_types"][type] = {{"files", count.files}, {"lines", count.lines}};
+        }
+        return projData;
+    }
+
+    // Read the scan settings (size_mode and exclude) from the configuration.
+    inline void loadScanOptions()
+    {
+        std::string sizeMode = Config::getOr("size_mode", "apparent");
+        if (sizeMode == "allocated")
+            Scanner::options.sizeMode = Scanner::SizeMode::Allocated;
+        else if (sizeMode == "apparent")
+            Scanner::options.sizeMode = Scanner::SizeMode::Apparent;
+        else
+            Canvas::PrintWarning("Unknown size_mode '" + sizeMode + "', expected 'apparent' or 'allocated'. Using apparent sizes.");
+
+        Scanner::options.excludes.clear();
+        std::istringstream iss(Config::getOr("exclude", ""));
+        std::string glob;
+        while (std::getline(iss, glob, ','))
+        {
+            glob = Config::trim(glob);
+            if (!glob.empty())
+                Scanner::options.excludes.push_back(glob);
         }
-        return totalSize;
+    }
+
+    // Project read back from its DevMap JSON representation.
+    // Projects written before multiple roots were supported live under the primary root.
+    inline Project ProjectFromJson(const nlohmann::json &projData)
+    {
+        Project proj;
+        proj.name = projData.value("name", "");
+        proj.folderName = projData.value("folderName", "");
+        proj.lang = projData.value("lang", "");
+        proj.createdBy = projData.value("created_by", "");
+        // Records journaled by an older devcore may still carry the text form.
+        const auto createdAt = projData.find("created_at");
+        if (createdAt != projData.end() && createdAt->is_string())
+            proj.createdAt = parseTime(createdAt->get<std::string>());
+        else
+            proj.createdAt = static_cast<time_t>(projData.value("created_at", static_cast<int64_t>(0)));
+        proj.size = projData.value("size", 0);
+        proj.gitSize = projData.value("git_size", 0);
+        proj.lastActivity = static_cast<time_t>(projData.value("last_activity", static_cast<int64_t>(0)));
+        proj.lastBuild = static_cast<time_t>(projData.value("last_build", static_cast<int64_t>(0)));
+        proj.usesGit = projData.value("git", false);
+        proj.root = projData.value("root", projectsPath.string());
+        proj.archived = projData.value("archived", false);
+        proj.archive = projData.value("archive", "");
+        proj.files = projData.value("files", static_cast<size_t>(0));
+        proj.lines = projData.value("lines", static_cast<size_t>(0));
+        if (projData.contains("file_types") && projData["file_types"].is_object())
+        {
+            for (const auto &[type, count] : projData["file_types"].items())
+                proj.fileTypes[type] = {count.value("files", static_cast<size_t>(0)), count.value("lines", static_cast<size_t>(0))};
+        }
+        return proj;
+    }
+
+    // Read the projects roots from the configuration.
+    // projects_path may hold a comma separated list, every entry is appended to $HOME.
+    inline void loadProjectRoots()
+    {
+        projectRoots.clear();
+        for (const auto &entry : Config::getList("projects_path"))
+            projectRoots.push_back(fs::path(Main::HOME_PATH + entry));
+        if (projectRoots.empty())
+            Canvas::PrintErrorExit("The 'projects_path' config key does not contain any path.");
+        projectsPath = projectRoots.front();
     }
 
     inline void CreateProject(const Project &proj)
     {
-        fs::path projPath = projectsPath / proj.lang / proj.folderName;
+        fs::path projPath = ProjectPath(proj);
         try
         {
             if (!fs::exists(projPath))
@@ -138,40 +330,421 @@ namespace DevMap
         }
     }
 
+    // Names of all installed templates as "<lang>/<template>".
+    inline std::vector<std::string> TemplateNames()
+    {
+        std::vector<std::string> names;
+        fs::path templateDir = Main::HOME_PATH + Main::TEMPLATE_PATH;
+        std::error_code ec;
+        for (auto it = fs::directory_iterator(templateDir, ec); !ec && it != fs::directory_iterator(); it.increment(ec))
+        {
+            if (!it->is_directory())
+                continue;
+            std::error_code subEc;
+            for (auto sub = fs::directory_iterator(it->path(), subEc); !subEc && sub != fs::directory_iterator(); sub.increment(subEc))
+            {
+                if (sub->is_directory())
+                    names.push_back(it->path().filename().string() + "/" + sub->path().filename().string());
+            }
+        }
+        return names;
+    }
+
+    // Write the name index read by `devcore __complete`.
+    // One "<kind>\t<name>" line per entry (p = project, l = language, t = template, d = project
+    // path), sorted, so completion can answer with a binary search without loading the config or
+    // the DevMap. `devcore jump` reads the project paths; archived projects have none.
+    // The first line, "#\t<NAME_INDEX_VERSION>", tells load() whether the index needs rewriting.
+    inline void WriteNameIndex()
+    {
+        std::vector<std::string> lines{"#\t" + std::to_string(NAME_INDEX_VERSION)};
+        if (devmapData.contains("Projects") && devmapData["Projects"].is_array())
+        {
+            for (const auto &projData : devmapData["Projects"])
+            {
+                lines.push_back("p\t" + projData.value("name", ""));
+                if (!projData.value("archived", false))
+                    lines.push_back("d\t" + ProjectPath(ProjectFromJson(projData)).string());
+            }
+        }
+        if (devmapData.contains("Languages") && devmapData["Languages"].is_array())
+        {
+            for (const auto &lang : devmapData["Languages"])
+                lines.push_back("l\t" + lang.get<std::string>());
+        }
+        for (const auto &templ : TemplateNames())
+            lines.push_back("t\t" + templ);
+        std::sort(lines.begin(), lines.end());
+        lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+
+        // Write to a temporary file first so a concurrent completion never reads a partial index.
+        std::string indexPath = Main::HOME_PATH + Main::INDEX_PATH;
+        std::string tmpPath = indexPath + ".tmp";
+        std::ofstream outFile(tmpPath, std::ios::trunc);
+        if (!outFile.is_open())
+            return;
+        for (const auto &line : lines)
+            outFile << line << '\n';
+        outFile.close();
+        std::error_code ec;
+        fs::rename(tmpPath, indexPath, ec);
+    }
+
+    // Whether the name index was written by this version of devcore.
+    inline bool NameIndexCurrent()
+    {
+        FILE *file = fopen((Main::HOME_PATH + Main::INDEX_PATH).c_str(), "r");
+        if (!file)
+            return false;
+        char line[32] = "";
+        bool current = fgets(line, sizeof(line), file) && std::string(line) == "#\t" + std::to_string(NAME_INDEX_VERSION) + "\n";
+        fclose(file);
+        return current;
+    }
+
+    // Identity of a project in the DevMap JSON: its root, language and folder.
+    inline std::string ProjectKey(const nlohmann::json &projData)
+    {
+        return projData.value("root", projectsPath.string()) + "\n" + projData.value("lang", "") + "\n" + projData.value("folderName", "");
+    }
+
+    // Journal records describing a single DevMap mutation.
+    inline nlohmann::json AddLangRecord(const std::string &lang) { return {{"op", "add_lang"}, {"lang", lang}}; }
+    inline nlohmann::json RemoveLangRecord(const std::string &lang) { return {{"op", "remove_lang"}, {"lang", lang}}; }
+    inline nlohmann::json PutProjectRecord(const Project &proj) { return {{"op", "put_project"}, {"project", ProjectToJson(proj)}}; }
+    // Changes to a project that already exists: only the given JSON keys, or all of them when none
+    // are given. Unlike put_project it does nothing once the project is gone, so a long command
+    // committing late cannot bring back a project another process deleted in the meantime.
+    inline nlohmann::json UpdateProjectRecord(const Project &proj, const std::vector<std::string> &fields = {})
+    {
+        nlohmann::json record = {{"op", "update_project"}, {"project", ProjectToJson(proj)}};
+        if (!fields.empty())
+            record["fields"] = fields;
+        return record;
+    }
+    inline nlohmann::json RemoveProjectRecord(const Project &proj) { return {{"op", "remove_project"}, {"project", ProjectToJson(proj)}}; }
+
+    // Apply a journal record to a DevMap JSON document.
+    // Records are idempotent, so replaying one that already made it into the snapshot is harmless.
+    // Returns true when the name index changes: a project or language added or removed, a project
+    // renamed, archived or restored.
+    inline bool ApplyRecord(nlohmann::json &data, const nlohmann::json &record)
+    {
+        std::string op = record.value("op", "");
+        if (!data.contains("Languages") || !data["Languages"].is_array())
+            data["Languages"] = nlohmann::json::array();
+        if (!data.contains("Projects") || !data["Projects"].is_array())
+            data["Projects"] = nlohmann::json::array();
+        nlohmann::json &langs = data["Languages"];
+        nlohmann::json &projs = data["Projects"];
+
+        if (op == "add_lang")
+        {
+            std::string lang = record.value("lang", "");
+            if (std::find(langs.begin(), langs.end(), lang) != langs.end())
+                return false;
+            langs.push_back(lang);
+            return true;
+        }
+        if (op == "remove_lang")
+        {
+            auto it = std::find(langs.begin(), langs.end(), record.value("lang", ""));
+            if (it == langs.end())
+                return false;
+            langs.erase(it);
+            return true;
+        }
+        if (op == "put_project" || op == "update_project" || op == "remove_project")
+        {
+            nlohmann::json projData = record.value("project", nlohmann::json::object());
+            std::string key = ProjectKey(projData);
+            auto it = std::find_if(projs.begin(), projs.end(), [&](const nlohmann::json &p) { return ProjectKey(p) == key; });
+            if (op == "remove_project")
+            {
+                if (it == projs.end())
+                    return false;
+                projs.erase(it);
+                return true;
+            }
+            if (it == projs.end())
+            {
+                if (op == "update_project")
+                    return false;
+                projs.push_back(projData);
+                return true;
+            }
+            if (op == "update_project" && record.contains("fields"))
+            {
+                // A field missing from the project is one ProjectToJson leaves out, e.g. no files counted.
+                nlohmann::json updated = *it;
+                for (const auto &field : record["fields"])
+                {
+                    std::string key = field.get<std::string>();
+                    if (projData.contains(key))
+                        updated[key] = projData[key];
+                    else
+                        updated.erase(key);
+                }
+                projData = updated;
+            }
+            bool indexed = it->value("name", "") != projData.value("name", "") || it->value("archived", false) != projData.value("archived", false);
+            *it = projData;
+            return indexed;
+        }
+        if (op == "set_users")
+        {
+            data["Users"] = record.value("users", nlohmann::json::array());
+        }
+        return false;
+    }
+
+    // Journal records that turn the `before` DevMap into `after` after a sync. Projects that were
+    // already listed only get the values a scan produces, as update_project records, so a sync
+    // never undoes what another process stored meanwhile (a build, stats or a rename).
+    inline std::vector<nlohmann::json> DiffRecords(const nlohmann::json &before, const nlohmann::json &after)
+    {
+        std::vector<nlohmann::json> records;
+        const nlohmann::json empty = nlohmann::json::array();
+        const nlohmann::json &beforeLangs = before.contains("Languages") ? before["Languages"] : empty;
+        const nlohmann::json &afterLangs = after.contains("Languages") ? after["Languages"] : empty;
+        for (const auto &lang : afterLangs)
+        {
+            if (std::find(beforeLangs.begin(), beforeLangs.end(), lang) == beforeLangs.end())
+                records.push_back(AddLangRecord(lang.get<std::string>()));
+        }
+        for (const auto &lang : beforeLangs)
+        {
+            if (std::find(afterLangs.begin(), afterLangs.end(), lang) == afterLangs.end())
+                records.push_back(RemoveLangRecord(lang.get<std::string>()));
+        }
+
+        std::map<std::string, const nlohmann::json *> beforeProjects;
+        if (before.contains("Projects"))
+        {
+            for (const auto &projData : before["Projects"])
+                beforeProjects[ProjectKey(projData)] = &projData;
+        }
+        if (after.contains("Projects"))
+        {
+            for (const auto &projData : after["Projects"])
+            {
+                auto it = beforeProjects.find(ProjectKey(projData));
+                if (it == beforeProjects.end())
+                {
+                    records.push_back({{"op", "put_project"}, {"project", projData}});
+                    continue;
+                }
+                std::vector<std::string> fields;
+                for (const char *field : {"size", "git_size", "git", "last_activity"})
+                {
+                    if (it->second->value(field, nlohmann::json()) != projData.value(field, nlohmann::json()))
+                        fields.push_back(field);
+                }
+                if (!fields.empty())
+                    records.push_back({{"op", "update_project"}, {"project", projData}, {"fields", fields}});
+                beforeProjects.erase(it);
+            }
+        }
+        for (const auto &leftover : beforeProjects)
+            records.push_back({{"op", "remove_project"}, {"project", *leftover.second}});
+
+        if (before.value("Users", empty) != after.value("Users", empty))
+            records.push_back({{"op", "set_users"}, {"users", after.value("Users", empty)}});
+        return records;
+    }
+
+    inline fs::path JournalPath()
+    {
+        return Journal::PathFor(devmapFileName);
+    }
+
+    // The directory holding the DevMap, readers lock it shared and writers exclusively.
+    inline fs::path LockPath()
+    {
+        return devmapFileName.parent_path();
+    }
+
+    inline ino_t InodeOf(const fs::path &path)
+    {
+        struct stat st;
+        return stat(path.c_str(), &st) == 0 ? st.st_ino : 0;
+    }
+
+    // Apply a replayed journal record and keep track of the newest generation seen.
+    inline void ReplayRecord(const nlohmann::json &record)
+    {
+        ApplyRecord(devmapData, record);
+        generation = std::max<uint64_t>(generation, record.value("gen", generation));
+    }
+
+    // Read the snapshot and replay the journal on top of it. The caller must hold the lock.
+    inline bool ReadState()
+    {
+        std::ifstream file(devmapFileName);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        try
+        {
+            file >> devmapData;
+        }
+        catch (const std::exception &e)
+        {
+            Canvas::PrintError("Failed to parse the DevMap file: " + std::string(e.what()));
+            return false;
+        }
+
+        snapshotInode = InodeOf(devmapFileName);
+        generation = devmapData.value("Generation", 0);
+        journalOffset = Journal::Replay(JournalPath(), ReplayRecord);
+        return true;
+    }
+
+    // Catch up with changes other processes made since we last read the DevMap.
+    // A new snapshot inode means someone compacted, so everything is read again; otherwise only
+    // the journal records past our offset are replayed. The caller must hold the exclusive lock.
+    inline void Refresh()
+    {
+        if (InodeOf(devmapFileName) != snapshotInode)
+            ReadState();
+        else
+            journalOffset = Journal::Replay(JournalPath(), ReplayRecord, journalOffset);
+        // Drop a torn tail left by a crashed writer so our records are not hidden behind it.
+        Journal::Truncate(JournalPath(), journalOffset);
+    }
+
+    // Write a full snapshot of the DevMap and fold the journal into it.
+    // The snapshot is written to a temporary file and renamed over the old one, so a crash leaves
+    // either the old snapshot plus its journal or the new snapshot, never a half-written file.
+    // The caller must hold the exclusive lock.
+    inline bool save()
+    {
+        devmapData["Generation"] = ++generation;
+        fs::path tmpPath = devmapFileName.string() + ".tmp";
+        std::ofstream outFile(tmpPath, std::ios::trunc);
+        if (!outFile.is_open())
+        {
+            Canvas::PrintError("Unable to write to DevMap file: " + devmapFileName.string());
+            return false;
+        }
+        outFile << devmapData.dump(4); // Pretty-print with indentations.
+        outFile.close();
+        std::error_code ec;
+        fs::rename(tmpPath, devmapFileName, ec);
+        if (ec)
+        {
+            Canvas::PrintError("Unable to write to DevMap file: " + devmapFileName.string() + " (" + ec.message() + ")");
+            return false;
+        }
+        snapshotInode = InodeOf(devmapFileName);
+        Journal::Clear(JournalPath());
+        journalOffset = 0;
+        WriteNameIndex();
+        return true;
+    }
+
+    // Apply mutation records to the DevMap and persist them.
+    // Records are appended to the journal, so the I/O cost does not depend on the size of the DevMap.
+    // Once the journal passes its size threshold it is compacted into a new snapshot.
+    //
+    // Concurrent devcore processes are merged optimistically: the exclusive lock is only held here,
+    // never while scanning. Under it, changes journaled by others since our last read are replayed
+    // first, then our records are applied on top and stamped with the next generation numbers.
+    inline bool Commit(std::vector<nlohmann::json> records)
+    {
+        if (records.empty())
+            return true;
+        if (deferCommits)
+        {
+            for (const auto &record : records)
+                ApplyRecord(devmapData, record);
+            deferred.insert(deferred.end(), records.begin(), records.end());
+            return true;
+        }
+
+        Lock::Guard lock(LockPath(), true);
+        Refresh();
+
+        bool namesChanged = false;
+        for (auto &record : records)
+        {
+            record["gen"] = ++generation;
+            namesChanged |= ApplyRecord(devmapData, record);
+        }
+
+        if (!Journal::Append(JournalPath(), records))
+            return save();
+        journalOffset = Journal::Size(JournalPath());
+        if (journalOffset > Journal::COMPACT_THRESHOLD)
+            return save();
+        if (namesChanged)
+            WriteNameIndex();
+        return true;
+    }
+
+    // Stop deferring and commit every queued record. Records are idempotent, so applying them
+    // again on top of what other processes wrote in the meantime is safe.
+    inline bool Flush()
+    {
+        deferCommits = false;
+        std::vector<nlohmann::json> records = std::move(deferred);
+        deferred.clear();
+        if (!Commit(records))
+            return false;
+        // The records were applied in memory already, so Commit cannot tell whether names changed.
+        if (!records.empty())
+            WriteNameIndex();
+        return true;
+    }
+
     inline void syncDevMap()
     {
         users.clear();
+        nlohmann::json before = devmapData;
 
-        // 1. Validate languages from JSON and remove those that no longer exist.
+        // 1. Validate languages from JSON and remove those that no longer exist under any root.
         std::vector<std::string> validLanguages;
         if (devmapData.contains("Languages") && devmapData["Languages"].is_array())
         {
             for (const auto &lang : devmapData["Languages"])
             {
                 std::string language = lang.get<std::string>();
-                fs::path langPath = projectsPath / language;
-                if (fs::exists(langPath))
+                bool exists = std::any_of(projectRoots.begin(), projectRoots.end(), [&](const fs::path &root) {
+                    return fs::exists(root / language);
+                });
+                if (exists)
                 {
                     validLanguages.push_back(language);
                 }
                 else
                 {
-                    Canvas::PrintInfo("Language '" + language + "' has been moved or deleted: " + langPath.string());
+                    Canvas::PrintInfo("Language '" + language + "' has been moved or deleted from every projects root.");
                 }
             }
         }
         languages = validLanguages;
 
-        // 2. Scan the filesystem for language directories not listed in JSON and add them.
-        for (const auto &entry : fs::directory_iterator(projectsPath))
+        // 2. Scan every root for language directories not listed in JSON and add them.
+        for (const auto &root : projectRoots)
         {
-            if (entry.is_directory())
+            if (!fs::is_directory(root))
+            {
+                Canvas::PrintWarning("Projects root does not exist: " + root.string());
+                continue;
+            }
+            for (const auto &entry : fs::directory_iterator(root))
             {
-                std::string langDir = entry.path().filename().string();
-                if (std::find(languages.begin(), languages.end(), langDir) == languages.end())
+                // Dot directories hold DevCore's own data (the trash), never a language.
+                if (entry.is_directory() && entry.path().filename().string()[0] != '.')
                 {
-                    languages.push_back(langDir);
-                    Canvas::PrintInfo("Added new language from filesystem to DevMap: " + langDir);
+                    std::string langDir = entry.path().filename().string();
+                    if (std::find(languages.begin(), languages.end(), langDir) == languages.end())
+                    {
+                        languages.push_back(langDir);
+                        Canvas::PrintInfo("Added new language from filesystem to DevMap: " + langDir);
+                    }
                 }
             }
         }
@@ -186,38 +759,16 @@ namespace DevMap
 
         // 3. Rebuild the projects vector from JSON, keeping only those projects that exist.
         std::vector<Project> validProjects;
-        nlohmann::json validProjectsJson = nlohmann::json::array();
         if (devmapData.contains("Projects") && devmapData["Projects"].is_array())
         {
             for (const auto &projData : devmapData["Projects"])
             {
-                std::string lang = projData.value("lang", "");
-                std::string folderName = projData.value("folderName", "");
-                fs::path projPath = projectsPath / lang / folderName;
-                if (fs::exists(projPath))
+                Project proj = ProjectFromJson(projData);
+                fs::path projPath = ProjectPath(proj);
+                // Archived projects are kept as stubs and never walked.
+                if (proj.archived || fs::exists(projPath))
                 {
-                    Project proj;
-                    proj.name = projData.value("name", "");
-                    proj.folderName = folderName;
-                    proj.lang = lang;
-                    proj.createdBy = projData.value("created_by", "");
-                    std::string createdAtStr = projData.value("created_at", "");
-                    proj.createdAt = parseTime(createdAtStr);
-                    proj.size = projData.value("size", 0);
-                    proj.usesGit = projData.value("git", false);
                     validProjects.push_back(proj);
-
-                    nlohmann::json projJson = {
-                        {"name", proj.name},
-                        {"folderName", proj.folderName},
-                        {"lang", proj.lang},
-                        {"created_by", proj.createdBy},
-                        {"created_at", timeToString(proj.createdAt)},
-                        {"size", proj.size},
-                        {"git", proj.usesGit}
-                    };
-                    validProjectsJson.push_back(projJson);
-
                     users.insert(proj.createdBy);
                 }
                 else
@@ -227,84 +778,68 @@ namespace DevMap
             }
         }
         projects = validProjects;
-        devmapData["Projects"] = validProjectsJson;
-
-        // 4.5. Update existing project data (size and Git status) from the filesystem.
-        for (auto &projData : devmapData["Projects"])
-        {
-            std::string language = projData.value("lang", "");
-            std::string folderName = projData.value("folderName", "");
-            fs::path projPath = projectsPath / language / folderName;
-            if (fs::exists(projPath) && fs::is_directory(projPath))
-            {
-                std::string fullProjPath = projPath.string();
-                size_t currentSize = getFolderSize(fullProjPath);
-                bool currentUsesGit = usesGit(fullProjPath);
-                projData["size"] = currentSize;
-                projData["git"] = currentUsesGit;
-                // Update the corresponding project in the projects vector.
-                for (auto &proj : projects)
-                {
-                    if (proj.folderName == folderName && proj.lang == language)
-                    {
-                        proj.size = currentSize;
-                        proj.usesGit = currentUsesGit;
-                        break;
-                    }
-                }
-            }
-        }
 
-        // 5. For every language directory, add any project directory not listed in the JSON.
-        for (const auto &language : languages)
+        // 4. For every language directory under every root, add any project directory not listed in the JSON.
+        std::set<fs::path> knownPaths;
+        for (const auto &proj : projects)
+            knownPaths.insert(ProjectPath(proj));
+        for (const auto &root : projectRoots)
         {
-            fs::path langPath = projectsPath / language;
-            if (!fs::exists(langPath))
-                continue;
-            for (const auto &entry : fs::directory_iterator(langPath))
+            for (const auto &language : languages)
             {
-                if (entry.is_directory())
+                fs::path langPath = root / language;
+                if (!fs::is_directory(langPath))
+                    continue;
+                for (const auto &entry : fs::directory_iterator(langPath))
                 {
-                    std::string folderName = entry.path().filename().string();
-                    bool found = false;
-                    for (const auto &proj : projects)
-                    {
-                        if (proj.folderName == folderName && proj.lang == language)
-                        {
-                            found = true;
-                            break;
-                        }
-                    }
-                    if (!found)
+                    if (entry.is_directory() && knownPaths.count(entry.path()) == 0)
                     {
                         // New project detected on the filesystem; add it with default values.
+                        std::string folderName = entry.path().filename().string();
                         Project newProj;
-                        std::string projectPath = (projectsPath / language / folderName).string();
                         newProj.name = folderName; // Default: use folder name as project name.
                         newProj.folderName = folderName;
                         newProj.lang = language;
                         newProj.createdBy = getCurrentUser();
                         newProj.createdAt = std::time(nullptr);
-                        newProj.size = getFolderSize(projectPath);
-                        newProj.usesGit = usesGit(projectPath);
+                        newProj.size = 0;
+                        newProj.usesGit = false;
+                        newProj.root = root;
                         projects.push_back(newProj);
-
-                        nlohmann::json newProjJson = {
-                            {"name", newProj.name},
-                            {"folderName", newProj.folderName},
-                            {"lang", newProj.lang},
-                            {"created_by", newProj.createdBy},
-                            {"created_at", timeToString(newProj.createdAt)},
-                            {"size", newProj.size},
-                            {"git", newProj.usesGit}
-                        };
-                        devmapData["Projects"].push_back(newProjJson);
-                        Canvas::PrintInfo("Added new project from filesystem to DevMap: " + folderName + " in " + language);
+                        knownPaths.insert(entry.path());
+                        Canvas::PrintInfo("Added new project from filesystem to DevMap: " + folderName + " in " + language + " (" + root.string() + ")");
                     }
                 }
             }
         }
 
+        // 5. Update project data (size and Git status) from the filesystem.
+        //    All roots are scanned concurrently, with one worker group per device.
+        std::vector<Scanner::Job> jobs;
+        std::vector<size_t> scanned;
+        jobs.reserve(projects.size());
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            if (projects[i].archived)
+                continue;
+            jobs.push_back({projects[i].root, ProjectPath(projects[i]), {}});
+            scanned.push_back(i);
+        }
+        Scanner::ScanAll(jobs);
+
+        for (size_t j = 0; j < jobs.size(); j++)
+        {
+            Project &proj = projects[scanned[j]];
+            proj.size = jobs[j].result.size;
+            proj.gitSize = jobs[j].result.gitSize;
+            proj.usesGit = jobs[j].result.usesGit;
+            proj.lastActivity = jobs[j].result.lastActivity;
+        }
+        nlohmann::json projectsJson = nlohmann::json::array();
+        for (const auto &proj : projects)
+            projectsJson.push_back(ProjectToJson(proj));
+        devmapData["Projects"] = projectsJson;
+
         // 6. Optionally update the users vector from JSON.
         if (devmapData.contains("Users") && devmapData["Users"].is_array())
         {
@@ -315,22 +850,60 @@ namespace DevMap
                 devmapData["Users"].push_back(user);
         }
 
-        // 7. Write the updated JSON back to the file.
-        std::ofstream outFile(devmapFileName);
-        if (outFile.is_open())
+        // 7. Record only what changed in the journal instead of rewriting the whole file.
+        std::vector<nlohmann::json> records = DiffRecords(before, devmapData);
+        devmapData = std::move(before);
+        Commit(records);
+    }
+
+    // Fill the in-memory projects, languages and users from the DevMap JSON without touching the
+    // projects roots. Used by commands that answer from the cached scan data.
+    inline void loadCached()
+    {
+        projects.clear();
+        languages.clear();
+        users.clear();
+        if (devmapData.contains("Projects") && devmapData["Projects"].is_array())
+        {
+            for (const auto &projData : devmapData["Projects"])
+            {
+                projects.push_back(ProjectFromJson(projData));
+                users.insert(projects.back().createdBy);
+            }
+        }
+        if (devmapData.contains("Languages") && devmapData["Languages"].is_array())
         {
-            outFile << devmapData.dump(4); // Pretty-print with indentations.
-            outFile.close();
+            for (const auto &lang : devmapData["Languages"])
+                languages.push_back(lang.get<std::string>());
         }
-        else
+        if (devmapData.contains("Users") && devmapData["Users"].is_array())
         {
-            Canvas::PrintError("Unable to write to DevMap file: " + devmapFileName.string());
+            for (const auto &user : devmapData["Users"])
+                users.insert(user.get<std::string>());
         }
     }
 
+    // Bring a DevMap document up to SCHEMA_VERSION. A DevMap written by a newer devcore is never
+    // rewritten, that is an error.
+    inline void MigrateSchema(nlohmann::json &data)
+    {
+        int version = data.value("Version", 1);
+        if (version > SCHEMA_VERSION)
+            Canvas::PrintErrorExit("The DevMap has schema version " + std::to_string(version) + ", this devcore only knows up to version " + std::to_string(SCHEMA_VERSION) + ". Update devcore first.");
+        if (version < 2 && data.contains("Projects") && data["Projects"].is_array())
+        {
+            for (auto &projData : data["Projects"])
+            {
+                if (projData.contains("created_at") && projData["created_at"].is_string())
+                    projData["created_at"] = static_cast<int64_t>(parseTime(projData["created_at"].get<std::string>()));
+            }
+        }
+        data["Version"] = SCHEMA_VERSION;
+    }
 
     // Load the DevMap from a JSON file.
-    inline bool load(const std::string &filename, bool install = false)
+    // With sync disabled the DevMap is used as-is, without rescanning the projects roots.
+    inline bool load(const std::string &filename, bool install = false, bool sync = true)
     {
 
         if (install)
@@ -358,7 +931,11 @@ namespace DevMap
                 Canvas::PrintErrorExit("Default DevMap file not found in the cloned repository.");
             }
             Canvas::PrintInfo("Copying the new DevMap to '" + Canvas::LinkText(filename, Canvas::Color::CYAN) + "'");
-            fs::copy_file(sourceConfig, devmapPath, fs::copy_options::overwrite_existing);
+            {
+                Lock::Guard lock(devmapDir, true);
+                fs::copy_file(sourceConfig, devmapPath, fs::copy_options::overwrite_existing);
+                Journal::Clear(Journal::PathFor(devmapPath));
+            }
             Canvas::PrintInfo("Removing the temporary cloned repository.");
             fs::remove_all("/tmp/devcore_repo");
             Canvas::PrintSuccess(Canvas::BoldText("Done installing the default DevMap.") +
@@ -367,25 +944,37 @@ namespace DevMap
                                  Canvas::LinkText(filename, Canvas::Color::GREEN) + "', however, this is not recommended!");
         }
 
-        // Save the filename and get projectsPath from configuration.
+        // Save the filename and get the projects roots from configuration.
         devmapFileName = filename;
-        projectsPath = Main::HOME_PATH + Config::get("projects_path");
+        loadProjectRoots();
+        loadScanOptions();
 
-        std::ifstream file(filename);
-        if (!file.is_open())
+        // Read the snapshot and replay the mutations recorded since, under a shared lock so a
+        // concurrent writer can never hand us a half-written state.
         {
-            return false;
+            Lock::Guard lock(LockPath(), false);
+            if (!ReadState())
+                return false;
         }
 
-        try
-        {
-            file >> devmapData;
-        }
-        catch (const std::exception &e)
+        // An older DevMap is migrated once: under the exclusive lock the state is read again,
+        // converted and written as a new snapshot, which also folds in any old journal records.
+        if (devmapData.value("Version", 1) != SCHEMA_VERSION)
         {
-            Canvas::PrintError("Failed to parse the DevMap file: " + std::string(e.what()));
-            return false;
+            Lock::Guard lock(LockPath(), true);
+            if (!ReadState())
+                return false;
+            // Another process may have migrated it in the meantime.
+            if (devmapData.value("Version", 1) != SCHEMA_VERSION)
+            {
+                MigrateSchema(devmapData);
+                if (!save())
+                    return false;
+            }
         }
+        // An index from an older devcore lacks entries that completion or jump now expect.
+        if (!NameIndexCurrent())
+            WriteNameIndex();
 
         // At this point the JSON has been read.
         // The expected JSON structure is:
@@ -396,18 +985,24 @@ namespace DevMap
         //             "folderName": "DevCore-project-manager",
         //             "lang": "C++",
         //             "created_by": "Huplo",
-        //             "created_at": "23:04 17-03-2025",
+        //             "created_at": 1742245440,
         //             "size": 25042,
         //             "git": true,
+        //             "root": "/home/huplo/Coding/Projects/"
         //         },
         //         ...
         //     ],
         //     "Languages": ["Java", "C++"],
-        //     "Users": ["Huplo"]
+        //     "Users": ["Huplo"],
+        //     "Version": 2,
+        //     "Generation": 12
         // }
 
         // Synchronize the JSON data with the filesystem.
-        syncDevMap();
+        if (sync)
+            syncDevMap();
+        else
+            loadCached();
 
         return true;
     }
@@ -432,6 +1027,8 @@ namespace DevMap
     {
         if (devmapData.empty())
         {
+            if (Canvas::embedded)
+                Canvas::PrintErrorExit("No DevMap loaded, '" + devmapFileName.string() + "' is missing or empty.");
             setup(devmapFileName);
             exit(0);
         }
@@ -461,7 +1058,7 @@ namespace DevMap
         }
         else
         {
-            header = {"Created By", "Name", "Folder", "Language", "Created At", "Size", "Git"};
+            header = {"Created By", "Name", "Folder", "Language", "Created At", "Size", "Lines", "Git", "Root"};
             for (const auto &proj : projects)
             {
                 rows.push_back({proj.createdBy,
@@ -470,22 +1067,955 @@ namespace DevMap
                                 proj.lang,
                                 timeToString(proj.createdAt),
                                 std::to_string(proj.size),
-                                proj.usesGit ? "Yes" : "No"});
+                                proj.files > 0 ? std::to_string(proj.lines) : "-",
+                                proj.usesGit ? "Yes" : "No",
+                                proj.archived ? "archived" : proj.root.string()});
             }
         }
         // Display the table with the default color.
         Canvas::PrintTable(" Projects ", header, rows, Canvas::Color::CYAN);
     }
 
-    inline void ListUsers()
+    // Disk usage report built from the sizes stored by the last scan, no directory is walked.
+    // Prints per-language totals and the topN largest projects, split into worktree and .git bytes.
+    inline void ListDiskUsage(size_t topN = 10, const std::string &langFilter = "")
     {
-        std::vector<std::string> header;
-        std::vector<std::vector<std::string>> rows;
-
-        header = {"Users"};
-        for (const auto &user : users)
+        struct Usage
         {
-            rows.push_back({user});
+            size_t projects = 0;
+            size_t worktree = 0;
+            size_t git = 0;
+        };
+        std::map<std::string, Usage> perLang;
+        Usage total;
+        std::vector<const Project *> candidates;
+        for (const auto &proj : projects)
+        {
+            if ((!langFilter.empty() && proj.lang != langFilter) || proj.archived)
+                continue;
+            size_t gitBytes = std::min(proj.gitSize, proj.size);
+            Usage &usage = perLang[proj.lang];
+            usage.projects++;
+            usage.worktree += proj.size - gitBytes;
+            usage.git += gitBytes;
+            total.projects++;
+            total.worktree += proj.size - gitBytes;
+            total.git += gitBytes;
+            candidates.push_back(&proj);
+        }
+
+        // Languages, largest first.
+        std::vector<std::pair<std::string, Usage>> langRows(perLang.begin(), perLang.end());
+        std::sort(langRows.begin(), langRows.end(), [](const auto &a, const auto &b) {
+            return a.second.worktree + a.second.git > b.second.worktree + b.second.git;
+        });
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &row : langRows)
+        {
+            rows.push_back({row.first,
+                            std::to_string(row.second.projects),
+                            HumanSize(row.second.worktree),
+                            HumanSize(row.second.git),
+                            HumanSize(row.second.worktree + row.second.git)});
+        }
+        rows.push_back({Canvas::BoldText("Total"),
+                        std::to_string(total.projects),
+                        HumanSize(total.worktree),
+                        HumanSize(total.git),
+                        Canvas::BoldText(HumanSize(total.worktree + total.git))});
+        Canvas::PrintTable(" Disk usage ", {"Language", "Projects", "Worktree", ".git", "Total"}, rows, Canvas::Color::CYAN);
+
+        // Only the topN largest projects need to be ordered.
+        size_t count = std::min(topN, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), [](const Project *a, const Project *b) {
+            return a->size > b->size;
+        });
+        rows.clear();
+        for (size_t i = 0; i < count; i++)
+        {
+            const Project *proj = candidates[i];
+            size_t gitBytes = std::min(proj->gitSize, proj->size);
+            rows.push_back({std::to_string(i + 1),
+                            proj->name,
+                            proj->lang,
+                            HumanSize(proj->size - gitBytes),
+                            HumanSize(gitBytes),
+                            HumanSize(proj->size)});
+        }
+        Canvas::PrintTable(" Top " + std::to_string(count) + " ", {"#", "Name", "Language", "Worktree", ".git", "Total"}, rows, Canvas::Color::CYAN);
+    }
+
+    // Remove the build artifacts of every project (optionally of one language) in parallel.
+    // Artifacts are found per project and then deleted one tree per task with unlinkat, the bytes
+    // that were freed are subtracted from the stored project sizes instead of rescanning.
+    inline void CleanProjects(const std::string &langFilter = "", bool dryRun = false)
+    {
+        struct Target
+        {
+            size_t project;
+            fs::path path;
+            FsUtil::RemoveResult result;
+        };
+
+        std::vector<size_t> selected;
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            if ((langFilter.empty() || projects[i].lang == langFilter) && !projects[i].archived)
+                selected.push_back(i);
+        }
+
+        std::vector<std::vector<std::string>> found(selected.size());
+        Parallel::ForEach(selected.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            const Project &proj = projects[selected[i]];
+            found[i] = Artifacts::Find(ProjectPath(proj), proj.lang);
+        });
+
+        std::vector<Target> targets;
+        for (size_t i = 0; i < selected.size(); i++)
+        {
+            for (const auto &relPath : found[i])
+                targets.push_back({selected[i], ProjectPath(projects[selected[i]]) / relPath, {}});
+        }
+        if (targets.empty())
+        {
+            Canvas::PrintInfo("Nothing to clean.");
+            return;
+        }
+
+        Parallel::ForEach(targets.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            targets[i].result = FsUtil::RemoveTree(targets[i].path, dryRun);
+        });
+
+        struct Reclaimed
+        {
+            size_t artifacts = 0;
+            size_t bytes = 0;
+        };
+        std::map<size_t, Reclaimed> perProject;
+        size_t totalBytes = 0;
+        for (const auto &target : targets)
+        {
+            if (!target.result.ok)
+                Canvas::PrintWarning("Could not fully remove '" + target.path.string() + "'.");
+            Reclaimed &reclaimed = perProject[target.project];
+            reclaimed.artifacts++;
+            reclaimed.bytes += target.result.bytes;
+            totalBytes += target.result.bytes;
+        }
+
+        std::vector<std::vector<std::string>> rows;
+        std::vector<nlohmann::json> records;
+        for (const auto &entry : perProject)
+        {
+            Project &proj = projects[entry.first];
+            rows.push_back({proj.name, proj.lang, std::to_string(entry.second.artifacts), HumanSize(entry.second.bytes)});
+            if (dryRun)
+                continue;
+            // The .git folder is never touched, so only worktree bytes can go.
+            proj.size -= std::min(entry.second.bytes, proj.size - std::min(proj.gitSize, proj.size));
+            records.push_back(UpdateProjectRecord(proj, {"size"}));
+        }
+        rows.push_back({Canvas::BoldText("Total"), "", std::to_string(targets.size()), Canvas::BoldText(HumanSize(totalBytes))});
+        Canvas::PrintTable(dryRun ? " Clean (dry run) " : " Clean ", {"Name", "Language", "Artifacts", dryRun ? "Reclaimable" : "Reclaimed"}, rows, Canvas::Color::CYAN);
+
+        if (dryRun)
+        {
+            Canvas::PrintInfo("Dry run, nothing was removed. " + HumanSize(totalBytes) + " can be reclaimed.");
+            return;
+        }
+        Commit(records);
+        Canvas::PrintSuccess("Reclaimed " + HumanSize(totalBytes) + ".");
+    }
+
+    // Replace identical files across the templates and every project with reflinks
+    // (or hard links when allowed) and report the bytes saved. Templates come first,
+    // so a template file is always the copy that is kept.
+    inline void DedupeProjects(bool dryRun = false, bool allowHardlink = false)
+    {
+        std::vector<fs::path> directories;
+        fs::path templates = Main::HOME_PATH + Main::TEMPLATE_PATH;
+        if (fs::is_directory(templates))
+            directories.push_back(templates);
+        for (const auto &proj : projects)
+        {
+            if (!proj.archived)
+                directories.push_back(ProjectPath(proj));
+        }
+
+        Dedupe::Report report = Dedupe::Run(directories, Main::HOME_PATH + Main::HASH_INDEX_PATH, dryRun, allowHardlink);
+
+        // The largest groups by bytes saved.
+        std::vector<const Dedupe::Group *> groups;
+        for (const auto &group : report.groups)
+            groups.push_back(&group);
+        size_t count = std::min<size_t>(10, groups.size());
+        std::partial_sort(groups.begin(), groups.begin() + count, groups.end(), [](const Dedupe::Group *a, const Dedupe::Group *b) {
+            return a->saved > b->saved;
+        });
+        std::vector<std::vector<std::string>> rows;
+        for (size_t i = 0; i < count; i++)
+        {
+            const Dedupe::Group *group = groups[i];
+            rows.push_back({group->files.front().path,
+                            std::to_string(group->files.size() - 1),
+                            HumanSize(group->files.front().size),
+                            HumanSize(group->saved)});
+        }
+        if (!rows.empty())
+            Canvas::PrintTable(" Largest duplicates ", {"Kept", "Copies", "Size", dryRun ? "Saveable" : "Saved"}, rows, Canvas::Color::CYAN);
+
+        rows = {{"Files scanned", std::to_string(report.scanned)},
+                {"Same size candidates", std::to_string(report.candidates)},
+                {"Files read", std::to_string(report.hashed) + " (" + std::to_string(report.candidates - report.hashed) + " answered by the index)"},
+                {"Duplicates", std::to_string(report.duplicates)}};
+        if (!dryRun)
+        {
+            rows.push_back({"Reflinked", std::to_string(report.reflinked)});
+            rows.push_back({"Hard linked", std::to_string(report.hardlinked)});
+            rows.push_back({"Skipped", std::to_string(report.skipped)});
+        }
+        rows.push_back({Canvas::BoldText(dryRun ? "Saveable" : "Saved"), Canvas::BoldText(HumanSize(report.saved))});
+        Canvas::PrintTable(dryRun ? " Dedupe (dry run) " : " Dedupe ", {"Step", "Result"}, rows, Canvas::Color::CYAN);
+
+        if (report.skipped > 0 && !allowHardlink)
+            Canvas::PrintInfo("Some duplicates could not be reflinked (the filesystem may not support it). Use --hardlink to hard link them instead.");
+    }
+
+    // Report pairs of projects whose file contents overlap by at least `threshold` (0 to 1), such
+    // as a project copied by hand into another language folder. Files shared with the templates
+    // do not count.
+    inline void FindSimilarProjects(double threshold = 0.6)
+    {
+        std::vector<const Project *> list;
+        std::vector<fs::path> paths;
+        for (const auto &proj : projects)
+        {
+            if (proj.archived)
+                continue;
+            list.push_back(&proj);
+            paths.push_back(ProjectPath(proj));
+        }
+
+        Similar::Result result = Similar::Run(paths, Main::HOME_PATH + Main::TEMPLATE_PATH, Main::HOME_PATH + Main::HASH_INDEX_PATH, Main::HOME_PATH + Main::SKETCH_INDEX_PATH);
+        size_t compared = 0;
+        std::vector<Similar::Pair> pairs = Similar::FindPairs(result.sketches, threshold, compared);
+
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &pair : pairs)
+        {
+            // The newer project is listed as the likely copy.
+            const Project *a = list[pair.a], *b = list[pair.b];
+            if (b->createdAt < a->createdAt)
+                std::swap(a, b);
+            rows.push_back({b->name + " (" + b->lang + ")",
+                            a->name + " (" + a->lang + ")",
+                            std::to_string(static_cast<int>(pair.similarity * 100 + 0.5)) + "%",
+                            HumanSize(b->size - std::min(b->gitSize, b->size))});
+        }
+        if (rows.empty())
+            Canvas::PrintInfo("No projects share " + std::to_string(static_cast<int>(threshold * 100 + 0.5)) + "% or more of their files.");
+        else
+            Canvas::PrintTable(" Similar projects ", {"Project", "Similar to", "Similarity", "Size"}, rows, Canvas::Color::CYAN);
+
+        rows = {{"Projects", std::to_string(list.size())},
+                {"Sketched", std::to_string(result.sketched) + " (" + std::to_string(list.size() - result.sketched) + " unchanged)"},
+                {"Files read", std::to_string(result.hashed)},
+                {"Pairs compared", std::to_string(compared) + " of " + std::to_string(list.size() * (list.size() - (list.empty() ? 0 : 1)) / 2)}};
+        Canvas::PrintTable(" Similarity ", {"Step", "Result"}, rows, Canvas::Color::CYAN);
+        if (!pairs.empty())
+            Canvas::PrintInfo("Remove a fork that is no longer needed with 'devcore delete-project', 'devcore trash undo' brings it back.");
+    }
+
+    // Build every project that has a Makefile through one shared jobserver, so at most `jobs`
+    // compile jobs run across all projects together. Projects whose sources did not change since
+    // their last successful build are skipped unless `force` is set. Returns false if a build failed.
+    inline bool BuildProjects(const std::string &langFilter = "", size_t jobs = 0, bool force = false)
+    {
+        struct Target
+        {
+            size_t project;
+            fs::path log;
+            bool upToDate = false;
+            Build::Result result;
+            time_t startedAt = 0;
+        };
+
+        if (jobs == 0)
+            jobs = Parallel::HardwareThreads();
+        std::vector<Target> targets;
+        size_t withoutMakefile = 0;
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            const Project &proj = projects[i];
+            if ((!langFilter.empty() && proj.lang != langFilter) || proj.archived)
+                continue;
+            if (!Build::HasMakefile(ProjectPath(proj)))
+            {
+                withoutMakefile++;
+                continue;
+            }
+            Target target;
+            target.project = i;
+            target.log = Main::HOME_PATH + Main::BUILD_LOG_PATH + proj.lang + "-" + proj.folderName + ".log";
+            targets.push_back(std::move(target));
+        }
+        if (targets.empty())
+        {
+            Canvas::PrintInfo("No projects with a Makefile to build.");
+            return true;
+        }
+
+        // The up-to-date checks walk every project, so they run on all cores before any build starts.
+        Parallel::ForEach(targets.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            const Project &proj = projects[targets[i].project];
+            targets[i].upToDate = !force && proj.lastBuild > 0 && Build::NewestSource(ProjectPath(proj), proj.lang) < proj.lastBuild;
+        });
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < targets.size(); i++)
+        {
+            if (!targets[i].upToDate)
+                pending.push_back(i);
+        }
+
+        Build::Jobserver jobserver;
+        std::string error;
+        if (!pending.empty() && !jobserver.Open(jobs, error))
+        {
+            Canvas::PrintError("Cannot start the jobserver: " + error);
+            return false;
+        }
+        if (!pending.empty())
+            Canvas::PrintInfo("Building " + std::to_string(pending.size()) + " project(s) with " + std::to_string(jobs) + " job(s).");
+
+        // One project runs in devcore's own implicit job slot, every other one holds a token while
+        // its make runs. Its sub-jobs take further tokens from the same pipe.
+        std::atomic<bool> implicitFree{true};
+        std::mutex outputMutex;
+        auto start = std::chrono::steady_clock::now();
+        Parallel::ForEach(pending.size(), jobs, [&](size_t i) {
+            Target &target = targets[pending[i]];
+            const Project &proj = projects[target.project];
+            bool expected = true;
+            bool implicit = implicitFree.compare_exchange_strong(expected, false);
+            if (!implicit)
+                jobserver.Acquire();
+            // The build time is taken before make starts, so a source saved while it runs is newer.
+            target.startedAt = std::time(nullptr);
+            target.result = Build::RunMake(ProjectPath(proj), jobserver, target.log);
+            if (implicit)
+                implicitFree = true;
+            else
+                jobserver.Release();
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            if (target.result.ok)
+            {
+                Canvas::PrintSuccess("Built '" + proj.name + "' in " + Build::Duration(target.result.seconds) + ".");
+                return;
+            }
+            Canvas::PrintError("Building '" + proj.name + "' failed after " + Build::Duration(target.result.seconds) + ": " + target.result.error + ".");
+            for (const auto &line : Build::Tail(target.log, 10))
+                Canvas::PrintColoredLine("    " + line);
+            Canvas::PrintInfo("Full log: " + target.log.string());
+        });
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        jobserver.Close();
+
+        size_t built = 0, failed = 0;
+        double total = 0;
+        std::vector<std::vector<std::string>> rows;
+        std::vector<nlohmann::json> records;
+        for (const auto &target : targets)
+        {
+            Project &proj = projects[target.project];
+            if (target.upToDate)
+            {
+                rows.push_back({proj.name, proj.lang, "up to date", "-"});
+                continue;
+            }
+            rows.push_back({proj.name, proj.lang, target.result.ok ? "built" : "failed", Build::Duration(target.result.seconds)});
+            total += target.result.seconds;
+            if (!target.result.ok)
+            {
+                failed++;
+                continue;
+            }
+            built++;
+            proj.lastBuild = target.startedAt;
+            records.push_back(UpdateProjectRecord(proj, {"last_build"}));
+        }
+        rows.push_back({Canvas::BoldText("Total"), "",
+                        std::to_string(built) + " built, " + std::to_string(failed) + " failed, " + std::to_string(targets.size() - pending.size()) + " up to date",
+                        Canvas::BoldText(Build::Duration(wall)) + " (" + Build::Duration(total) + " summed)"});
+        Canvas::PrintTable(" Build ", {"Name", "Language", "Status", "Time"}, rows, Canvas::Color::CYAN);
+        if (withoutMakefile > 0)
+            Canvas::PrintInfo(std::to_string(withoutMakefile) + " project(s) without a Makefile were skipped.");
+
+        Commit(records);
+        return failed == 0;
+    }
+
+    // Include graph of the C and C++ projects (`projectName` limits it to one project).
+    // format is "" for the summary tables, "dot" or "json" for the whole graph. With `rdeps` set,
+    // lists every file that includes that header, directly or through other headers.
+    inline bool PrintDeps(const std::string &projectName, const std::string &langFilter, const std::string &format, const std::string &rdeps)
+    {
+        std::vector<Deps::ProjectInput> inputs;
+        for (const auto &proj : projects)
+        {
+            if (proj.archived || !Deps::IsCLanguage(proj.lang) || (!langFilter.empty() && proj.lang != langFilter))
+                continue;
+            if (!projectName.empty() && proj.name != projectName)
+                continue;
+            inputs.push_back({proj.name, ProjectPath(proj), proj.lang});
+        }
+        if (inputs.empty())
+        {
+            if (!projectName.empty())
+                Canvas::PrintError("No C or C++ project named '" + projectName + "'.");
+            else
+                Canvas::PrintInfo("No C or C++ projects to scan.");
+            return projectName.empty();
+        }
+
+        // Only a run over every project may drop cache entries of projects it did not see.
+        Deps::Graph graph = Deps::Build(inputs, Main::HOME_PATH + Main::DEPS_CACHE_PATH, projectName.empty() && langFilter.empty());
+        if (format == "dot")
+        {
+            Canvas::Out() << Deps::ToDot(graph);
+            return true;
+        }
+        if (format == "json")
+        {
+            Canvas::Out() << Deps::ToJson(graph).dump(2) << std::endl;
+            return true;
+        }
+
+        if (!rdeps.empty())
+        {
+            std::vector<size_t> targets = Deps::Match(graph, rdeps);
+            if (targets.empty())
+            {
+                Canvas::PrintError("No file or external header matches '" + rdeps + "'.");
+                return false;
+            }
+            std::map<size_t, size_t> dependents = Deps::Dependents(graph, targets);
+            std::vector<std::pair<size_t, size_t>> order;
+            for (const auto &[node, depth] : dependents)
+                order.push_back({depth, node});
+            std::sort(order.begin(), order.end(), [&](const auto &a, const auto &b) {
+                return a.first != b.first ? a.first < b.first : graph.nodes[a.second].id < graph.nodes[b.second].id;
+            });
+
+            std::vector<std::vector<std::string>> rows;
+            size_t sources = 0;
+            for (const auto &[depth, node] : order)
+            {
+                const Deps::Node &n = graph.nodes[node];
+                sources += n.source;
+                rows.push_back({graph.projects[n.project].name, n.relPath, n.source ? "source" : "header", depth == 1 ? "direct" : std::to_string(depth)});
+            }
+            if (rows.empty())
+            {
+                Canvas::PrintInfo("Nothing includes '" + rdeps + "'.");
+                return true;
+            }
+            Canvas::PrintTable(" Dependents of " + rdeps + " ", {"Project", "File", "Kind", "Depth"}, rows, Canvas::Color::CYAN);
+            Canvas::PrintInfo(std::to_string(sources) + " source file(s) recompile when it changes.");
+            return true;
+        }
+
+        struct Counts
+        {
+            size_t sources = 0, headers = 0, includes = 0;
+            std::set<size_t> external;
+        };
+        std::vector<Counts> counts(graph.projects.size());
+        std::vector<std::pair<size_t, size_t>> externalUse; // Includers, node.
+        std::vector<size_t> includers(graph.nodes.size(), 0);
+        for (size_t from = 0; from < graph.edges.size(); from++)
+        {
+            const Deps::Node &node = graph.nodes[from];
+            if (node.external)
+                continue;
+            Counts &c = counts[node.project];
+            (node.source ? c.sources : c.headers)++;
+            c.includes += graph.edges[from].size();
+            for (size_t to : graph.edges[from])
+            {
+                includers[to]++;
+                if (graph.nodes[to].external)
+                    c.external.insert(to);
+            }
+        }
+
+        std::vector<std::vector<std::string>> rows;
+        for (size_t p = 0; p < graph.projects.size(); p++)
+            rows.push_back({graph.projects[p].name, std::to_string(counts[p].sources), std::to_string(counts[p].headers), std::to_string(counts[p].includes), std::to_string(counts[p].external.size())});
+        Canvas::PrintTable(" Includes ", {"Project", "Sources", "Headers", "Includes", "External"}, rows, Canvas::Color::CYAN);
+
+        for (size_t i = 0; i < graph.nodes.size(); i++)
+        {
+            if (graph.nodes[i].external)
+                externalUse.push_back({includers[i], i});
+        }
+        std::sort(externalUse.begin(), externalUse.end(), [&](const auto &a, const auto &b) {
+            return a.first != b.first ? a.first > b.first : graph.nodes[a.second].relPath < graph.nodes[b.second].relPath;
+        });
+        if (externalUse.size() > 10)
+            externalUse.resize(10);
+        if (!externalUse.empty())
+        {
+            std::vector<std::vector<std::string>> externalRows;
+            for (const auto &[count, node] : externalUse)
+                externalRows.push_back({graph.nodes[node].relPath, std::to_string(count)});
+            Canvas::PrintTable(" Most included external headers ", {"Header", "Included by"}, externalRows, Canvas::Color::CYAN);
+        }
+        Canvas::PrintInfo(std::to_string(graph.parsed + graph.cached) + " file(s), " + std::to_string(graph.parsed) + " parsed, " + std::to_string(graph.cached) + " from cache.");
+        return true;
+    }
+
+    // Count files and lines of every project (`projectName` or `langFilter` narrow it down), store
+    // them in the DevMap for `list-all` and print them per project, per language and per file type.
+    inline bool ProjectStats(const std::string &projectName = "", const std::string &langFilter = "")
+    {
+        std::vector<size_t> selected;
+        std::vector<Stats::ProjectInput> inputs;
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            const Project &proj = projects[i];
+            if (proj.archived || (!langFilter.empty() && proj.lang != langFilter) || (!projectName.empty() && proj.name != projectName))
+                continue;
+            selected.push_back(i);
+            inputs.push_back({ProjectPath(proj), proj.lang});
+        }
+        if (selected.empty())
+        {
+            if (!projectName.empty())
+                Canvas::PrintError("No project named '" + projectName + "'.");
+            else
+                Canvas::PrintInfo("No projects to count.");
+            return projectName.empty();
+        }
+
+        // Only a run over every project may drop cache entries of projects it did not see.
+        Stats::Result result = Stats::Scan(inputs, Main::HOME_PATH + Main::STATS_CACHE_PATH, projectName.empty() && langFilter.empty());
+
+        std::vector<nlohmann::json> records;
+        std::map<std::string, Stats::Count> perLang, perType;
+        std::map<std::string, size_t> projectsPerLang;
+        Stats::Count total;
+        for (size_t s = 0; s < selected.size(); s++)
+        {
+            Project &proj = projects[selected[s]];
+            Stats::Count count;
+            for (const auto &[type, typeCount] : result.types[s])
+            {
+                count.files += typeCount.files;
+                count.lines += typeCount.lines;
+                perType[type].files += typeCount.files;
+                perType[type].lines += typeCount.lines;
+            }
+            perLang[proj.lang].files += count.files;
+            perLang[proj.lang].lines += count.lines;
+            projectsPerLang[proj.lang]++;
+            total.files += count.files;
+            total.lines += count.lines;
+
+            bool changed = proj.files != count.files || proj.lines != count.lines || proj.fileTypes.size() != result.types[s].size();
+            for (const auto &[type, typeCount] : result.types[s])
+            {
+                auto stored = proj.fileTypes.find(type);
+                changed = changed || stored == proj.fileTypes.end() || stored->second.files != typeCount.files || stored->second.lines != typeCount.lines;
+            }
+            proj.files = count.files;
+            proj.lines = count.lines;
+            proj.fileTypes = result.types[s];
+            if (changed)
+                records.push_back(UpdateProjectRecord(proj, {"files", "lines", "file_types"}));
+        }
+
+        auto share = [&](size_t lines) {
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "%.1f%%", total.lines > 0 ? 100.0 * lines / total.lines : 0.0);
+            return std::string(buffer);
+        };
+        auto byLines = [](const auto &a, const auto &b) {
+            return a.second.lines != b.second.lines ? a.second.lines > b.second.lines : a.first < b.first;
+        };
+
+        // Projects, largest first, with their three main file types.
+        std::vector<size_t> order = selected;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return projects[a].lines != projects[b].lines ? projects[a].lines > projects[b].lines : projects[a].name < projects[b].name;
+        });
+        std::vector<std::vector<std::string>> rows;
+        for (size_t i : order)
+        {
+            const Project &proj = projects[i];
+            std::vector<std::pair<std::string, Stats::Count>> types(proj.fileTypes.begin(), proj.fileTypes.end());
+            std::sort(types.begin(), types.end(), byLines);
+            std::string mainTypes;
+            for (size_t t = 0; t < types.size() && t < 3 && types[t].second.lines > 0; t++)
+                mainTypes += (mainTypes.empty() ? "" : ", ") + types[t].first;
+            rows.push_back({proj.name, proj.lang, Stats::Grouped(proj.files), Stats::Grouped(proj.lines), mainTypes});
+        }
+        rows.push_back({Canvas::BoldText("Total"), "", Stats::Grouped(total.files), Canvas::BoldText(Stats::Grouped(total.lines)), ""});
+        Canvas::PrintTable(" Projects ", {"Name", "Language", "Files", "Lines", "Main types"}, rows, Canvas::Color::CYAN);
+
+        std::vector<std::pair<std::string, Stats::Count>> langRows(perLang.begin(), perLang.end());
+        std::sort(langRows.begin(), langRows.end(), byLines);
+        rows.clear();
+        for (const auto &[lang, count] : langRows)
+            rows.push_back({lang, std::to_string(projectsPerLang[lang]), Stats::Grouped(count.files), Stats::Grouped(count.lines), share(count.lines)});
+        Canvas::PrintTable(" Languages ", {"Language", "Projects", "Files", "Lines", "Share"}, rows, Canvas::Color::CYAN);
+
+        std::vector<std::pair<std::string, Stats::Count>> typeRows(perType.begin(), perType.end());
+        std::sort(typeRows.begin(), typeRows.end(), byLines);
+        rows.clear();
+        for (const auto &[type, count] : typeRows)
+            rows.push_back({type, Stats::Grouped(count.files), Stats::Grouped(count.lines), share(count.lines)});
+        Canvas::PrintTable(" File types ", {"Type", "Files", "Lines", "Share"}, rows, Canvas::Color::CYAN);
+        Canvas::PrintInfo(std::to_string(result.counted + result.cached) + " file(s), " + std::to_string(result.counted) + " counted, " + std::to_string(result.cached) + " from cache.");
+
+        return Commit(records);
+    }
+
+    // Live view of every project (size, uncommitted changes, last activity) until 'q' or Ctrl-C.
+    // Nothing is polled: the loop sleeps until inotify reports a change, a key is pressed or the
+    // minute changes (ages are shown in minutes). Changed projects are rescanned once their
+    // changes settle and the new values are committed to the DevMap. Frames go through
+    // Screen::Screen, so only the cells that changed are redrawn.
+    inline void WatchProjects()
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto settle = std::chrono::milliseconds(200); // Quiet time before a rescan.
+        const auto maxDelay = std::chrono::seconds(1);      // Rescan at least this often during a stream of changes.
+        const time_t highlight = 5;                         // Seconds a changed project stays highlighted.
+
+        struct Row
+        {
+            bool dirty = false;  // Uncommitted changes in its git repository.
+            time_t changedAt = 0; // When the watch last saw its values change.
+        };
+
+        if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO))
+            Canvas::PrintErrorExit("'devcore watch' needs a terminal.");
+        Watch::Watcher watcher;
+        std::string error;
+        if (!watcher.Open(error) || !Watch::CatchSignals())
+            Canvas::PrintErrorExit("Cannot watch the projects: " + (error.empty() ? std::string(std::strerror(errno)) : error));
+
+        std::vector<Row> rows;
+        auto setup = [&]() {
+            watcher.Close();
+            watcher.Open(error);
+            for (const auto &root : projectRoots)
+            {
+                watcher.AddLayout(root);
+                for (const auto &lang : languages)
+                {
+                    if (fs::is_directory(root / lang))
+                        watcher.AddLayout(root / lang);
+                }
+            }
+            rows.assign(projects.size(), Row{});
+            Parallel::ForEach(projects.size(), Parallel::HardwareThreads(), [&](size_t i) {
+                if (!projects[i].archived && projects[i].usesGit)
+                    rows[i].dirty = Watch::GitDirty(ShellQuote(ProjectPath(projects[i]).string()));
+            });
+            for (size_t i = 0; i < projects.size(); i++)
+            {
+                if (!projects[i].archived)
+                    watcher.AddProject(static_cast<long>(i), ProjectPath(projects[i]), projects[i].lang);
+            }
+        };
+
+        auto rescan = [&](const std::set<long> &changed) {
+            std::vector<Scanner::Job> jobs;
+            std::vector<size_t> scanned;
+            for (long i : changed)
+            {
+                if (i < 0 || static_cast<size_t>(i) >= projects.size() || projects[i].archived)
+                    continue;
+                jobs.push_back({projects[i].root, ProjectPath(projects[i]), {}});
+                scanned.push_back(static_cast<size_t>(i));
+            }
+            Scanner::ScanAll(jobs);
+            std::vector<char> dirty(scanned.size(), 0);
+            Parallel::ForEach(scanned.size(), Parallel::HardwareThreads(), [&](size_t j) {
+                if (jobs[j].result.usesGit)
+                    dirty[j] = Watch::GitDirty(ShellQuote(jobs[j].path.string()));
+            });
+
+            std::vector<nlohmann::json> records;
+            time_t now = std::time(nullptr);
+            for (size_t j = 0; j < scanned.size(); j++)
+            {
+                Project &proj = projects[scanned[j]];
+                const Scanner::Result &result = jobs[j].result;
+                bool changedValues = proj.size != result.size || proj.gitSize != result.gitSize || proj.usesGit != result.usesGit || proj.lastActivity != result.lastActivity;
+                if (changedValues || rows[scanned[j]].dirty != static_cast<bool>(dirty[j]))
+                    rows[scanned[j]].changedAt = now;
+                rows[scanned[j]].dirty = dirty[j];
+                if (!changedValues)
+                    continue;
+                proj.size = result.size;
+                proj.gitSize = result.gitSize;
+                proj.usesGit = result.usesGit;
+                proj.lastActivity = result.lastActivity;
+                // Only the scanned values, a build or stats run since startup keeps its own.
+                records.push_back(UpdateProjectRecord(proj, {"size", "git_size", "git", "last_activity"}));
+            }
+            Commit(records);
+        };
+
+        size_t offset = 0; // First project shown.
+        size_t page = 1;
+        Screen::Screen screen;
+        auto render = [&]() {
+            time_t now = std::time(nullptr);
+            size_t height = screen.Rows(), width = screen.Cols();
+            page = height > 4 ? height - 4 : 1;
+
+            std::vector<size_t> order;
+            size_t dirtyCount = 0;
+            for (size_t i = 0; i < projects.size(); i++)
+            {
+                order.push_back(i);
+                dirtyCount += rows[i].dirty;
+            }
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return projects[a].lastActivity != projects[b].lastActivity ? projects[a].lastActivity > projects[b].lastActivity : projects[a].name < projects[b].name;
+            });
+            offset = std::min(offset, order.size() > page ? order.size() - page : 0);
+
+            // Name takes what the fixed columns leave.
+            const size_t langWidth = 12, sizeWidth = 10, gitWidth = 6, ageWidth = 12;
+            size_t fixed = langWidth + sizeWidth + gitWidth + ageWidth + 5;
+            size_t nameWidth = width > fixed + 8 ? width - fixed : 8;
+            size_t langCol = nameWidth + 1, sizeCol = langCol + langWidth + 1, gitCol = sizeCol + sizeWidth + 1, ageCol = gitCol + gitWidth + 1;
+
+            screen.Clear();
+            screen.Put(0, 0, " DevCore | Watch", Canvas::Color::CYAN, true);
+            std::string summary = std::to_string(projects.size()) + " projects, " + std::to_string(dirtyCount) + " with uncommitted changes ";
+            if (summary.size() + 18 < width)
+                screen.Put(0, width - summary.size(), summary, Canvas::Color::CYAN);
+            screen.Put(1, 1, "Name", Canvas::Color::YELLOW, true, nameWidth - 1);
+            screen.Put(1, langCol, "Language", Canvas::Color::YELLOW, true);
+            screen.Put(1, sizeCol, "Size", Canvas::Color::YELLOW, true);
+            screen.Put(1, gitCol, "Git", Canvas::Color::YELLOW, true);
+            screen.Put(1, ageCol, "Last activity", Canvas::Color::YELLOW, true);
+            screen.Fill(2, 0, width, "─", Canvas::Color::CYAN);
+
+            for (size_t k = 0; k < page && offset + k < order.size(); k++)
+            {
+                size_t i = order[offset + k];
+                const Project &proj = projects[i];
+                size_t row = 3 + k;
+                bool fresh = rows[i].changedAt > 0 && now - rows[i].changedAt < highlight;
+                Canvas::Color color = fresh ? Canvas::Color::GREEN : Canvas::Color::DEFAULT;
+                screen.Put(row, 1, proj.name, color, fresh, nameWidth - 1);
+                screen.Put(row, langCol, proj.lang, color, false, langWidth);
+                screen.Put(row, sizeCol, proj.archived ? "-" : HumanSize(proj.size), color, false, sizeWidth);
+                if (!proj.usesGit || proj.archived)
+                    screen.Put(row, gitCol, "-", color);
+                else if (rows[i].dirty)
+                    screen.Put(row, gitCol, "dirty", Canvas::Color::YELLOW);
+                else
+                    screen.Put(row, gitCol, "clean", Canvas::Color::GREEN);
+                screen.Put(row, ageCol, proj.archived ? "archived" : AgeString(proj.lastActivity, now), color, false, ageWidth);
+            }
+
+            std::string keys = " ↑/↓ scroll  PgUp/PgDn page  q quit";
+            screen.Put(height - 1, 0, keys, Canvas::Color::CYAN);
+            std::string status = watcher.Exhausted() ? "inotify watch limit reached, some folders are not watched " : std::to_string(watcher.Count()) + " folders watched ";
+            if (status.size() + Canvas::DisplayLength(keys) < width)
+                screen.Put(height - 1, width - status.size(), status, watcher.Exhausted() ? Canvas::Color::RED : Canvas::Color::CYAN);
+            screen.Present();
+        };
+
+        setup();
+        bool wasSilent = Canvas::silent;
+        Canvas::silent = true; // Nothing may print over the screen.
+        screen.Open();
+
+        std::set<long> pending;
+        bool layout = false;
+        Clock::time_point firstEvent, lastEvent;
+        bool running = true, redraw = true;
+        while (running)
+        {
+            if (redraw)
+                render();
+            redraw = false;
+
+            // Sleep until the pending changes settle, or else until the shown ages or highlights change.
+            int timeout;
+            time_t now = std::time(nullptr);
+            if (!pending.empty() || layout)
+            {
+                auto due = std::min(lastEvent + settle, firstEvent + maxDelay);
+                timeout = static_cast<int>(std::max<long>(0, std::chrono::duration_cast<std::chrono::milliseconds>(due - Clock::now()).count()));
+            }
+            else
+            {
+                time_t wake = now + 60 - now % 60;
+                for (const auto &row : rows)
+                {
+                    if (row.changedAt + highlight > now)
+                        wake = std::min(wake, row.changedAt + highlight);
+                }
+                timeout = static_cast<int>(wake - now) * 1000;
+            }
+
+            pollfd fds[3] = {{watcher.Fd(), POLLIN, 0}, {STDIN_FILENO, POLLIN, 0}, {Watch::signalPipe[0], POLLIN, 0}};
+            int ready = poll(fds, 3, timeout);
+            if (ready < 0 && errno != EINTR)
+                break;
+            if (ready == 0)
+                redraw = true;
+
+            if (ready > 0 && (fds[2].revents & POLLIN))
+            {
+                char c;
+                while (read(Watch::signalPipe[0], &c, 1) == 1)
+                {
+                    if (c == 'q')
+                        running = false;
+                    else
+                        screen.Resize();
+                }
+                redraw = true;
+            }
+            if (ready > 0 && (fds[1].revents & POLLIN))
+            {
+                char buffer[64];
+                ssize_t length = read(STDIN_FILENO, buffer, sizeof(buffer));
+                for (ssize_t i = 0; i < length; i++)
+                {
+                    char c = buffer[i];
+                    if (c == 'q' || c == 'Q')
+                        running = false;
+                    else if (c == 'j')
+                        offset++;
+                    else if (c == 'k')
+                        offset = offset > 0 ? offset - 1 : 0;
+                    else if (c == '\033' && i + 2 < length && buffer[i + 1] == '[')
+                    {
+                        char key = buffer[i + 2];
+                        i += 2;
+                        if (key == 'A')
+                            offset = offset > 0 ? offset - 1 : 0;
+                        else if (key == 'B')
+                            offset++;
+                        else if (key == 'H')
+                            offset = 0;
+                        else if (key == 'F')
+                            offset = SIZE_MAX;
+                        else if (key == '5' || key == '6')
+                        {
+                            offset = key == '5' ? (offset > page ? offset - page : 0) : offset + page;
+                            if (i + 1 < length && buffer[i + 1] == '~')
+                                i++;
+                        }
+                    }
+                }
+                redraw = true;
+            }
+            if (ready > 0 && (fds[0].revents & POLLIN))
+            {
+                if (pending.empty() && !layout)
+                    firstEvent = Clock::now();
+                lastEvent = Clock::now();
+                // Lost events leave no way to tell what changed, so everything is synced again.
+                if (!watcher.Read(pending, layout))
+                    layout = true;
+            }
+
+            if ((!pending.empty() || layout) && Clock::now() >= std::min(lastEvent + settle, firstEvent + maxDelay))
+            {
+                if (layout)
+                {
+                    syncDevMap();
+                    setup();
+                }
+                else
+                {
+                    rescan(pending);
+                }
+                pending.clear();
+                layout = false;
+                redraw = true;
+            }
+        }
+
+        screen.Close();
+        Canvas::silent = wasSilent;
+    }
+
+    inline void PrintActivityTable(const std::string &title, const std::vector<const Project *> &list)
+    {
+        time_t now = std::time(nullptr);
+        std::vector<std::vector<std::string>> rows;
+        for (const Project *proj : list)
+        {
+            rows.push_back({proj->name,
+                            proj->lang,
+                            proj->lastActivity > 0 ? timeToString(proj->lastActivity) : "-",
+                            AgeString(proj->lastActivity, now)});
+        }
+        Canvas::PrintTable(title, {"Name", "Language", "Last activity", "Age"}, rows, Canvas::Color::CYAN);
+    }
+
+    // The count most recently active projects, from the last_activity stored by the last scan.
+    // Only the top count entries are ordered.
+    inline void ListRecentProjects(size_t count)
+    {
+        std::vector<const Project *> candidates;
+        for (const auto &proj : projects)
+        {
+            if (!proj.archived)
+                candidates.push_back(&proj);
+        }
+        count = std::min(count, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), [](const Project *a, const Project *b) {
+            return a->lastActivity > b->lastActivity;
+        });
+        candidates.resize(count);
+        PrintActivityTable(" Recent projects ", candidates);
+    }
+
+    // Projects without any file change in the last `days` days, least recently active first.
+    inline void ListStaleProjects(long days)
+    {
+        time_t cutoff = std::time(nullptr) - static_cast<time_t>(days) * 86400;
+        std::vector<const Project *> stale;
+        for (const auto &proj : projects)
+        {
+            if (!proj.archived && proj.lastActivity < cutoff)
+                stale.push_back(&proj);
+        }
+        std::sort(stale.begin(), stale.end(), [](const Project *a, const Project *b) {
+            return a->lastActivity < b->lastActivity;
+        });
+        if (stale.empty())
+        {
+            Canvas::PrintInfo("Every project was active in the last " + std::to_string(days) + " days.");
+            return;
+        }
+        PrintActivityTable(" Stale for " + std::to_string(days) + "+ days ", stale);
+    }
+
+    inline void ListUsers()
+    {
+        std::vector<std::string> header;
+        std::vector<std::vector<std::string>> rows;
+
+        header = {"Users"};
+        for (const auto &user : users)
+        {
+            rows.push_back({user});
         }
         // Display the table with the default color.
         Canvas::PrintTable("", header, rows, Canvas::Color::CYAN);
@@ -499,31 +2029,13 @@ namespace DevMap
         // Build the template directory path
         std::string templateDir = Main::HOME_PATH + Main::TEMPLATE_PATH + "/";
 
-        try {
-            // Check if the template directory exists and is a directory
-            if (fs::exists(templateDir) && fs::is_directory(templateDir)) {
-                // Iterate over first-level directories (subdir1)
-                for (const auto& entry : fs::directory_iterator(templateDir)) {
-                    if (entry.is_directory()) {
-                        std::string subdir1Name = entry.path().filename().string();
-
-                        // Iterate over second-level directories (subdir2) inside each subdir1
-                        for (const auto& subentry : fs::directory_iterator(entry.path())) {
-                            if (subentry.is_directory()) { // You can modify this condition if you also want files
-                                std::string subdir2Name = subentry.path().filename().string();
-                                // Combine the names with a '/'
-                                std::string templateName = subdir1Name + "/" + subdir2Name;
-                                rows.push_back({templateName});
-                            }
-                        }
-                    }
-                }
-            } else {
-                std::cerr << "Directory not found: " << templateDir << std::endl;
-            }
-        }
-        catch (const fs::filesystem_error& e) {
-            std::cerr << "Filesystem error: " << e.what() << std::endl;
+        // Check if the template directory exists and is a directory
+        if (fs::exists(templateDir) && fs::is_directory(templateDir)) {
+            // Every template is stored as <lang>/<template>.
+            for (const auto &templateName : TemplateNames())
+                rows.push_back({templateName});
+        } else {
+            std::cerr << "Directory not found: " << templateDir << std::endl;
         }
 
         // Display the table with the default color.
@@ -544,25 +2056,27 @@ namespace DevMap
         Canvas::PrintTable("", header, rows, Canvas::Color::CYAN);
     }
 
-    inline void DeleteLanguage(std::string &lang)
+    inline bool DeleteLanguage(const std::string &lang)
     {
         // Verify that the language exists in the languages vector.
         auto it = std::find(languages.begin(), languages.end(), lang);
         if (it == languages.end())
         {
-            Canvas::PrintInfo("Language '" + lang + "' does not exist.");
-            return;
+            Canvas::PrintError("Language '" + lang + "' does not exist.");
+            return false;
         }
 
-        // Construct paths for the language and template directories.
-        fs::path langPath = projectsPath / lang;
+        // Construct paths for the language directory under every root and the template directory.
+        std::vector<fs::path> langPaths;
+        for (const auto &root : projectRoots)
+            langPaths.push_back(root / lang);
         fs::path templatePath = Main::HOME_PATH + Main::TEMPLATE_PATH + "/" + lang;
 
         bool returnEarly = false;
-        // Check if the language directory exists and is empty.
-        if (fs::exists(langPath))
+        // Check if the language directories exist and are empty.
+        for (const auto &langPath : langPaths)
         {
-            if (!fs::is_empty(langPath))
+            if (fs::exists(langPath) && !fs::is_empty(langPath))
             {
                 Canvas::PrintError("Cannot delete language directory '" + langPath.string() + "': Directory is not empty. You will have to empty this yourself or by deleting each project with DevCore commands.");
                 returnEarly = true;
@@ -580,18 +2094,20 @@ namespace DevMap
         }
 
         if (returnEarly)
-            return;
+            return false;
         
 
-        // Attempt to delete the language directory.
-        if (fs::exists(langPath))
+        // Attempt to delete the language directories.
+        for (const auto &langPath : langPaths)
         {
+            if (!fs::exists(langPath))
+                continue;
             if (fs::remove(langPath))
                 Canvas::PrintInfo("Deleted language directory: " + langPath.string());
             else
             {
                 Canvas::PrintError("Failed to delete language directory: " + langPath.string());
-                return;
+                return false;
             }
         }
         
@@ -603,123 +2119,360 @@ namespace DevMap
             else
             {
                 Canvas::PrintError("Failed to delete template directory: " + templatePath.string());
-                return;
+                return false;
             }
         }
 
         // Remove the language from the languages vector.
         languages.erase(it);
 
-        // Update the JSON: remove the language from the "Languages" array.
-        if (devmapData.contains("Languages") && devmapData["Languages"].is_array())
+        // Record the removal in the DevMap.
+        if (!Commit({RemoveLangRecord(lang)}))
+            return false;
+        Canvas::PrintInfo("DevMap updated successfully.");
+        return true;
+    }
+
+    // Whether a language, folder or template name stays one directory below its parent: not
+    // empty, no '/' and no leading '.', which also rules out "." and "..".
+    inline bool ValidComponent(const std::string &name)
+    {
+        return !name.empty() && name.find('/') == std::string::npos && name[0] != '.';
+    }
+
+    // Create a language under the primary root, a language that already exists is left as is.
+    inline bool CreateLang(const std::string &lang)
+    {
+        if (!ValidComponent(lang))
         {
-            nlohmann::json newLangArray = nlohmann::json::array();
-            for (const auto &item : devmapData["Languages"])
+            Canvas::PrintError("Invalid language name '" + lang + "'.");
+            return false;
+        }
+        // Check if the language is already in the vector.
+        if (std::find(languages.begin(), languages.end(), lang) == languages.end())
+        {
+            // Add to the languages vector.
+            languages.push_back(lang);
+
+            // Create the language folder if it does not exist.
+            fs::path langPath = projectsPath / lang;
+            if (!fs::exists(langPath))
             {
-                if (item.get<std::string>() != lang)
-                {
-                    newLangArray.push_back(item);
-                }
+                fs::create_directories(langPath);
+                Canvas::PrintInfo("Created language directory: " + langPath.string());
             }
-            devmapData["Languages"] = newLangArray;
-        }
 
-        // Write the updated JSON back to the file.
-        std::ofstream outFile(devmapFileName);
-        if (outFile.is_open())
-        {
-            outFile << devmapData.dump(4); // Pretty-print with indentations.
-            outFile.close();
+            fs::path templatePath =  Main::HOME_PATH + Main::TEMPLATE_PATH + '/' + lang;
+            if (!fs::exists(templatePath))
+            {
+                fs::create_directories(templatePath);
+                Canvas::PrintInfo("Created template directory: " + templatePath.string());
+            }
+
+            // Add the language to the DevMap.
+            Canvas::PrintInfo("Added language to DevMap: " + lang);
+            if (!Commit({AddLangRecord(lang)}))
+                return false;
             Canvas::PrintInfo("DevMap updated successfully.");
         }
         else
         {
-            Canvas::PrintError("Unable to write updated DevMap to: " + devmapFileName.string());
+            Canvas::PrintInfo("Language already exists: " + lang);
         }
+        return true;
+    }
+
+    // Values for the {{placeholders}} of a template.
+    inline std::map<std::string, std::string> TemplateVariables(const std::string &name, const std::string &folderName, const std::string &lang)
+    {
+        time_t now = std::time(nullptr);
+        char year[8], date[16];
+        std::strftime(year, sizeof(year), "%Y", std::localtime(&now));
+        std::strftime(date, sizeof(date), "%Y-%m-%d", std::localtime(&now));
+        return {
+            {"project_name", name},
+            {"project_folder", folderName},
+            {"lang", lang},
+            {"author", getCurrentUser()},
+            {"year", year},
+            {"date", date}
+        };
+    }
+
+    // Derive a folder name from a project name using GitHub naming conventions.
+    inline std::string FolderNameFromName(const std::string &projectName)
+    {
+        std::string folderName = projectName;
+        // Convert to lowercase.
+        std::transform(folderName.begin(), folderName.end(), folderName.begin(), ::tolower);
+        // Replace spaces with hyphens.
+        std::replace(folderName.begin(), folderName.end(), ' ', '-');
+        // Remove any characters other than alphanumeric or hyphen.
+        folderName.erase(std::remove_if(folderName.begin(), folderName.end(),
+            [](char c) { return !(std::isalnum(c) || c == '-'); }), folderName.end());
+        return folderName;
     }
 
+    // Everything needed to create a project without asking the user anything.
+    struct ProjectSpec
+    {
+        std::string name;         // Virtual name for the manager.
+        std::string folderName;   // Folder name, derived from the name when empty.
+        std::string lang;         // Language, created when it does not exist yet.
+        std::string templateName; // Template inside the language's template directory, optional.
+        bool git = false;         // Initialize a Git repository.
+    };
+
+    // Read project specs from a JSON manifest.
+    // Accepts either {"projects": [...]} or a bare array of objects with the keys
+    // "name", "lang" and optionally "folder", "template" and "git".
+    inline bool LoadManifest(const std::string &filename, std::vector<ProjectSpec> &specs)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open())
+        {
+            Canvas::PrintError("Unable to open manifest: " + filename);
+            return false;
+        }
+
+        nlohmann::json manifest;
+        try
+        {
+            file >> manifest;
+        }
+        catch (const std::exception &e)
+        {
+            Canvas::PrintError("Failed to parse the manifest: " + std::string(e.what()));
+            return false;
+        }
+
+        const nlohmann::json empty = nlohmann::json::array();
+        const nlohmann::json &entries = manifest.is_array() ? manifest : manifest.is_object() ? manifest.value("projects", empty) : empty;
+        if (!entries.is_array() || (!manifest.is_array() && !manifest.contains("projects")))
+        {
+            Canvas::PrintError("The manifest must contain a \"projects\" array.");
+            return false;
+        }
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            const nlohmann::json &entry = entries[i];
+            std::string where = "Manifest entry " + std::to_string(i);
+            if (!entry.is_object())
+            {
+                Canvas::PrintError(where + " is not an object.");
+                return false;
+            }
+            // Checked here, nlohmann's value() throws on a mistyped key.
+            for (const char *key : {"name", "lang", "folder", "template"})
+            {
+                if (entry.contains(key) && !entry[key].is_string())
+                {
+                    Canvas::PrintError(where + ": \"" + key + "\" must be a string.");
+                    return false;
+                }
+            }
+            if (entry.contains("git") && !entry["git"].is_boolean())
+            {
+                Canvas::PrintError(where + ": \"git\" must be true or false.");
+                return false;
+            }
+            ProjectSpec spec;
+            spec.name = entry.value("name", "");
+            spec.lang = entry.value("lang", "");
+            spec.folderName = entry.value("folder", "");
+            spec.templateName = entry.value("template", "");
+            spec.git = entry.value("git", false);
+            specs.push_back(spec);
+        }
+        return true;
+    }
 
-    inline void CreateLang(std::string &lang)
+    // Create the project directory, apply the template and initialize Git.
+    // Touches nothing but the project directory, so it is safe to run for several projects at once.
+    // The template files are copied on `workers` threads and the bytes written are added to `written`.
+    inline bool InstantiateProject(const ProjectSpec &spec, const fs::path &projPath, const std::map<std::string, std::string> &variables,
+                                   std::string &error, size_t workers, uint64_t &written)
     {
-        // Check if the language is already in the vector.
-        if (std::find(languages.begin(), languages.end(), lang) == languages.end())
+        std::error_code ec;
+        fs::create_directories(projPath, ec);
+        if (ec)
         {
-            // Add to the languages vector.
-            languages.push_back(lang);
+            error = "Error creating project directory '" + projPath.string() + "': " + ec.message();
+            return false;
+        }
 
-            // Create the language folder if it does not exist.
-            fs::path langPath = projectsPath / lang;
-            if (!fs::exists(langPath))
+        if (!spec.templateName.empty())
+        {
+            fs::path templatePath = fs::path(Main::HOME_PATH + Main::TEMPLATE_PATH) / spec.lang / spec.templateName;
+            std::string templateError;
+            if (!Template::Instantiate(templatePath, projPath, variables, templateError, workers, &written))
             {
-                fs::create_directories(langPath);
-                Canvas::PrintInfo("Created language directory: " + langPath.string());
+                error = "Error applying template '" + spec.templateName + "': " + templateError;
+                return false;
             }
+        }
 
-            fs::path templatePath =  Main::HOME_PATH + Main::TEMPLATE_PATH + '/' + lang;
-            if (!fs::exists(templatePath))
+        if (spec.git)
+        {
+            std::string initCommand = "git init -q " + ShellQuote(projPath.string()) + " > /dev/null 2>&1";
+            if (std::system(initCommand.c_str()) != 0)
             {
-                fs::create_directories(templatePath);
-                Canvas::PrintInfo("Created template directory: " + templatePath.string());
+                error = "Failed to initialize Git repository in " + projPath.string();
+                return false;
             }
+        }
+        return true;
+    }
 
-            // Ensure the JSON "Languages" array exists.
-            if (!devmapData.contains("Languages") || !devmapData["Languages"].is_array())
+    // Create many projects in one transaction.
+    // All specs are validated first, then the directories, templates and Git repositories are set up
+    // in parallel. If any project fails, everything created so far is removed again and the DevMap is
+    // left untouched, otherwise every change is committed with a single DevMap write.
+    inline bool CreateProjects(std::vector<ProjectSpec> specs)
+    {
+        // 1. Validate every spec before touching the filesystem.
+        std::vector<std::string> errors;
+        std::set<fs::path> seenPaths;
+        std::set<std::string> seenNames;
+        for (auto &spec : specs)
+        {
+            if (spec.folderName.empty())
+                spec.folderName = FolderNameFromName(spec.name);
+            if (spec.name.empty() || spec.lang.empty() || spec.folderName.empty())
+            {
+                errors.push_back("Every project needs a name and a language (got name '" + spec.name + "', lang '" + spec.lang + "').");
+                continue;
+            }
+            if (!ValidComponent(spec.lang) || !ValidComponent(spec.folderName) || (!spec.templateName.empty() && !ValidComponent(spec.templateName)))
             {
-                devmapData["Languages"] = nlohmann::json::array();
+                errors.push_back("Project '" + spec.name + "': language, folder and template names may not contain '/' or start with '.' (got lang '" + spec.lang + "', folder '" + spec.folderName + "', template '" + spec.templateName + "').");
+                continue;
             }
+            fs::path projPath = projectsPath / spec.lang / spec.folderName;
+            if (findProjectByName(projects, spec.name) != nullptr)
+                errors.push_back("A project named '" + spec.name + "' already exists.");
+            else if (!seenNames.insert(spec.name).second)
+                errors.push_back("Project name '" + spec.name + "' is used more than once.");
+            if (fs::exists(projPath))
+                errors.push_back("Project directory already exists: " + projPath.string());
+            else if (!seenPaths.insert(projPath).second)
+                errors.push_back("Project directory '" + projPath.string() + "' is used more than once.");
+            if (!spec.templateName.empty() && !fs::is_directory(fs::path(Main::HOME_PATH + Main::TEMPLATE_PATH) / spec.lang / spec.templateName))
+                errors.push_back("Template '" + spec.lang + "/" + spec.templateName + "' does not exist.");
+        }
+        if (!errors.empty())
+        {
+            for (const auto &error : errors)
+                Canvas::PrintError(error);
+            Canvas::PrintError("No projects were created.");
+            return false;
+        }
 
-            // Add the language to the JSON data.
-            devmapData["Languages"].push_back(lang);
-            Canvas::PrintInfo("Added language to DevMap: " + lang);
+        // 2. Create the language directories that do not exist yet.
+        std::vector<std::string> newLanguages;
+        std::vector<fs::path> createdDirs;
+        for (const auto &spec : specs)
+        {
+            if (std::find(languages.begin(), languages.end(), spec.lang) != languages.end() ||
+                std::find(newLanguages.begin(), newLanguages.end(), spec.lang) != newLanguages.end())
+                continue;
+            newLanguages.push_back(spec.lang);
+            fs::path langPath = projectsPath / spec.lang;
+            std::error_code ec;
+            if (!fs::exists(langPath) && fs::create_directories(langPath, ec))
+                createdDirs.push_back(langPath);
+        }
 
-            // Write the updated JSON back to the file.
-            std::ofstream outFile(devmapFileName);
-            if (outFile.is_open())
+        // 3. Set up every project in parallel.
+        std::vector<std::string> projectErrors(specs.size());
+        std::vector<char> created(specs.size(), 0);
+        std::vector<Scanner::Result> scans(specs.size());
+        // Built up front, getpwuid and localtime are not safe to call from the workers.
+        std::vector<std::map<std::string, std::string>> variables;
+        // Template manifests are refreshed here once, not by several workers at the same time.
+        std::set<fs::path> templates;
+        for (const auto &spec : specs)
+        {
+            variables.push_back(TemplateVariables(spec.name, spec.folderName, spec.lang));
+            if (!spec.templateName.empty())
+                templates.insert(fs::path(Main::HOME_PATH + Main::TEMPLATE_PATH) / spec.lang / spec.templateName);
+        }
+        for (const auto &templatePath : templates)
+            Template::ManifestFor(templatePath);
+        // One project uses every core for its files, many projects get a core each.
+        size_t fileWorkers = specs.size() == 1 ? Parallel::HardwareThreads() : 1;
+        Parallel::ForEach(specs.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            fs::path projPath = projectsPath / specs[i].lang / specs[i].folderName;
+            created[i] = 1;
+            uint64_t written = 0;
+            if (!InstantiateProject(specs[i], projPath, variables[i], projectErrors[i], fileWorkers, written))
+                return;
+            // Without Git the project holds exactly the bytes that were written, no walk needed.
+            if (specs[i].git || Scanner::options.sizeMode != Scanner::SizeMode::Apparent)
             {
-                outFile << devmapData.dump(4); // Pretty-print with indentations.
-                outFile.close();
-                Canvas::PrintInfo("DevMap updated successfully.");
+                scans[i] = Scanner::ScanProject(projPath);
             }
             else
             {
-                Canvas::PrintError("Unable to write updated DevMap to: " + devmapFileName.string());
+                scans[i].size = written;
+                scans[i].lastActivity = std::time(nullptr);
             }
-        }
-        else
-        {
-            Canvas::PrintInfo("Language already exists: " + lang);
-        }
-    }
+        });
 
-    inline void CopyDirectory(const fs::path& source, const fs::path& destination)
-    {
-        try
+        // 4. Roll back everything if a single project failed.
+        bool failed = std::any_of(projectErrors.begin(), projectErrors.end(), [](const std::string &e) { return !e.empty(); });
+        if (failed)
         {
-            // Ensure destination exists
-            if (!fs::exists(destination))
+            for (const auto &error : projectErrors)
             {
-                fs::create_directories(destination);
+                if (!error.empty())
+                    Canvas::PrintError(error);
             }
-
-            for (const auto& entry : fs::directory_iterator(source))
+            for (size_t i = 0; i < specs.size(); i++)
             {
-                const fs::path& pathInSource = entry.path();
-                fs::path pathInDestination = destination / pathInSource.filename();
-
-                if (fs::is_directory(pathInSource))
-                {
-                    CopyDirectory(pathInSource, pathInDestination);
-                }
-                else
-                {
-                    fs::copy_file(pathInSource, pathInDestination, fs::copy_options::overwrite_existing);
-                }
+                std::error_code ec;
+                if (created[i])
+                    fs::remove_all(projectsPath / specs[i].lang / specs[i].folderName, ec);
+            }
+            for (const auto &dir : createdDirs)
+            {
+                std::error_code ec;
+                fs::remove(dir, ec);
             }
+            Canvas::PrintError("Rolled back, no projects were created.");
+            return false;
+        }
+
+        // 5. Commit every change to the DevMap with a single write.
+        std::vector<nlohmann::json> records;
+        for (const auto &lang : newLanguages)
+        {
+            languages.push_back(lang);
+            records.push_back(AddLangRecord(lang));
+            fs::create_directories(fs::path(Main::HOME_PATH + Main::TEMPLATE_PATH) / lang);
         }
-        catch (const std::exception& e)
+        std::string user = getCurrentUser();
+        for (size_t i = 0; i < specs.size(); i++)
         {
-            Canvas::PrintError(u8"Error copying directory: " + std::string(e.what()));
+            Project newProj;
+            newProj.name = specs[i].name;
+            newProj.folderName = specs[i].folderName;
+            newProj.lang = specs[i].lang;
+            newProj.createdBy = user;
+            newProj.createdAt = std::time(nullptr);
+            newProj.size = scans[i].size;
+            newProj.gitSize = scans[i].gitSize;
+            newProj.lastActivity = scans[i].lastActivity;
+            newProj.usesGit = specs[i].git;
+            newProj.root = projectsPath;
+            projects.push_back(newProj);
+            records.push_back(PutProjectRecord(newProj));
         }
+        if (!Commit(records))
+            return false;
+
+        Canvas::PrintSuccess(u8"✅ Created " + std::to_string(specs.size()) + " project(s).");
+        return true;
     }
 
     inline void CreateProjectWizard()
@@ -755,14 +2508,7 @@ namespace DevMap
         std::string projectFolderName;
         if (useNamingConvention)
         {
-            projectFolderName = projectName;
-            // Convert to lowercase.
-            std::transform(projectFolderName.begin(), projectFolderName.end(), projectFolderName.begin(), ::tolower);
-            // Replace spaces with hyphens.
-            std::replace(projectFolderName.begin(), projectFolderName.end(), ' ', '-');
-            // Remove any characters other than alphanumeric or hyphen.
-            projectFolderName.erase(std::remove_if(projectFolderName.begin(), projectFolderName.end(),
-                [](char c) { return !(std::isalnum(c) || c == '-'); }), projectFolderName.end());
+            projectFolderName = FolderNameFromName(projectName);
             Canvas::PrintInfo(u8"📁 Using folder name: " + projectFolderName);
         }
         else
@@ -838,6 +2584,8 @@ namespace DevMap
         newProj.createdAt = std::time(nullptr);
         newProj.size = 0;  // Will be updated if a template is applied.
         newProj.usesGit = initGit;
+        newProj.lastActivity = newProj.createdAt;
+        newProj.root = projectsPath;
 
         // 7. Create the project directory.
         CreateProject(newProj);
@@ -850,17 +2598,14 @@ namespace DevMap
         {
             fs::path templatePath = Main::HOME_PATH + Main::TEMPLATE_PATH + "/" + projectLang + "/" + selectedTemplate;
             fs::path projectPath = projectsPath / projectLang / projectFolderName;
-            try
-            {
-                CopyDirectory(templatePath, projectPath);
+            std::string templateError;
+            uint64_t written = 0;
+            if (Template::Instantiate(templatePath, projectPath, TemplateVariables(projectName, projectFolderName, projectLang), templateError, Parallel::HardwareThreads(), &written))
                 Canvas::PrintSuccess(u8"✨ Template '" + selectedTemplate + "' applied to project.");
-            }
-            catch (const std::exception &e)
-            {
-                Canvas::PrintError(u8"Error copying template: " + std::string(e.what()));
-            }
-            // Update project size after copying template contents.
-            newProj.size = getFolderSize(projectPath.string());
+            else
+                Canvas::PrintError(u8"Error copying template: " + templateError);
+            // The template manifest gives the size directly, only allocated sizes need a walk.
+            newProj.size = Scanner::options.sizeMode == Scanner::SizeMode::Apparent ? written : getFolderSize(projectPath.string());
         }
 
         // 9. Initialize Git repository if requested.
@@ -878,27 +2623,9 @@ namespace DevMap
             }
         }
 
-        // 10. Update the DevMap JSON with the new project entry.
-        nlohmann::json projJson = {
-            {"name", newProj.name},
-            {"folderName", newProj.folderName},
-            {"lang", newProj.lang},
-            {"created_by", newProj.createdBy},
-            {"created_at", timeToString(newProj.createdAt)},
-            {"size", newProj.size},
-            {"git", newProj.usesGit}
-        };
-        devmapData["Projects"].push_back(projJson);
-        std::ofstream outFile(devmapFileName);
-        if (outFile.is_open())
-        {
-            outFile << devmapData.dump(4); // Pretty-print with indentations.
-            outFile.close();
-        }
-        else
-        {
-            Canvas::PrintError("Unable to write to DevMap file: " + devmapFileName.string());
-        }
+        // 10. Update the DevMap with the new project entry.
+        projects.push_back(newProj);
+        Commit({PutProjectRecord(newProj)});
         Canvas::PrintSuccess(u8"✅ Project '" + newProj.name + "' created successfully!");
 
         if (openInCode)
@@ -913,6 +2640,245 @@ namespace DevMap
     }
 
 
+    // Directory the project archives are written to (archive_path, appended to $HOME).
+    inline fs::path ArchiveRoot()
+    {
+        return fs::path(Main::HOME_PATH + Config::getOr("archive_path", Main::ARCHIVE_PATH));
+    }
+
+    // Pack a project into <archive root>/<lang>/<folder>.tar.zst and replace it with a DevMap stub.
+    // The project tree is moved to the trash and purged in the background once the archive is written.
+    inline bool ArchiveProject(const std::string &projectName)
+    {
+        const Project *found = findProjectByName(projects, projectName);
+        if (found == nullptr)
+        {
+            Canvas::PrintError("No project named '" + projectName + "'.");
+            return false;
+        }
+        Project proj = *found;
+        if (proj.archived)
+        {
+            Canvas::PrintError("Project '" + projectName + "' is already archived in " + proj.archive.string());
+            return false;
+        }
+        fs::path projPath = ProjectPath(proj);
+        if (!fs::is_directory(projPath))
+        {
+            Canvas::PrintError("Project directory '" + projPath.string() + "' does not exist.");
+            return false;
+        }
+
+        fs::path archive = ArchiveRoot() / proj.lang / (proj.folderName + Archive::EXTENSION);
+        for (int n = 1; fs::exists(archive); n++)
+            archive = ArchiveRoot() / proj.lang / (proj.folderName + "-" + std::to_string(n) + Archive::EXTENSION);
+
+        Canvas::PrintInfo("Archiving '" + proj.name + "' (" + HumanSize(proj.size) + ") to " + Canvas::LinkText(archive.string()));
+        std::string error;
+        if (!Archive::Pack(projPath, archive, error))
+        {
+            Canvas::PrintError("Failed to archive '" + proj.name + "': " + error);
+            return false;
+        }
+
+        std::string trashError;
+        if (Trash::MoveToTrash(proj.root, projPath, {{"project", ProjectToJson(proj)}, {"archive", archive.string()}}, 0, trashError).empty())
+            FsUtil::RemoveTree(projPath);
+
+        proj.archived = true;
+        proj.archive = archive;
+        Commit({UpdateProjectRecord(proj)});
+        Trash::SpawnPurger(projectRoots);
+
+        std::error_code ec;
+        Canvas::PrintSuccess("Archived '" + proj.name + "', " + HumanSize(proj.size) + " packed into " + HumanSize(fs::file_size(archive, ec)) + ".");
+        return true;
+    }
+
+    // Unpack an archived project back to where it was and rescan it.
+    // The archive is extracted into a dot directory of the root first and renamed into place,
+    // so an interrupted restore never shows up as a half-filled project.
+    inline bool RestoreProject(const std::string &projectName)
+    {
+        const Project *found = findProjectByName(projects, projectName);
+        if (found == nullptr || !found->archived)
+        {
+            Canvas::PrintError("No archived project named '" + projectName + "'.");
+            return false;
+        }
+        Project proj = *found;
+        fs::path projPath = ProjectPath(proj);
+        if (fs::exists(projPath))
+        {
+            Canvas::PrintError("Cannot restore, '" + projPath.string() + "' already exists.");
+            return false;
+        }
+
+        std::error_code ec;
+        fs::path staging = proj.root / (".devcore-restore-" + std::to_string(getpid()));
+        fs::create_directories(staging, ec);
+        fs::create_directories(projPath.parent_path(), ec);
+        std::string error;
+        if (ec || !Archive::Unpack(proj.archive, staging, error))
+        {
+            Canvas::PrintError("Failed to restore '" + proj.name + "': " + (ec ? ec.message() : error));
+            FsUtil::RemoveTree(staging);
+            return false;
+        }
+        if (rename((staging / proj.folderName).c_str(), projPath.c_str()) != 0)
+        {
+            Canvas::PrintError("Failed to move the restored project into place: " + std::string(std::strerror(errno)));
+            FsUtil::RemoveTree(staging);
+            return false;
+        }
+        FsUtil::RemoveTree(staging);
+        fs::remove(proj.archive, ec);
+
+        Scanner::Result scan = Scanner::ScanProject(projPath);
+        proj.archived = false;
+        proj.archive.clear();
+        proj.size = scan.size;
+        proj.gitSize = scan.gitSize;
+        proj.usesGit = scan.usesGit;
+        proj.lastActivity = scan.lastActivity;
+        std::vector<nlohmann::json> records;
+        if (std::find(languages.begin(), languages.end(), proj.lang) == languages.end())
+            records.push_back(AddLangRecord(proj.lang));
+        records.push_back(UpdateProjectRecord(proj));
+        Commit(records);
+        Canvas::PrintSuccess("Restored '" + proj.name + "' to " + Canvas::LinkText(projPath.string()));
+        return true;
+    }
+
+    // Seconds a deleted project can still be restored from the trash.
+    inline long TrashGrace()
+    {
+        long grace = std::strtol(Config::getOr("trash_grace", std::to_string(Trash::DEFAULT_GRACE)).c_str(), nullptr, 10);
+        return grace < 0 ? 0 : grace;
+    }
+
+    // Show the deleted projects that have not been purged yet.
+    // Entries whose worker died before purging them are handed to a new worker.
+    inline void ListTrash()
+    {
+        std::vector<Trash::Entry> entries = Trash::List(projectRoots);
+        if (entries.empty())
+        {
+            Canvas::PrintInfo("The trash is empty.");
+            return;
+        }
+
+        time_t now = std::time(nullptr);
+        bool overdue = false;
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &entry : entries)
+        {
+            if (entry.purging)
+            {
+                rows.push_back({entry.id, "", "", "", "purging"});
+                continue;
+            }
+            Project proj = ProjectFromJson(entry.meta.value("project", nlohmann::json::object()));
+            time_t purgeAt = Trash::PurgeAt(entry);
+            overdue = overdue || purgeAt <= now;
+            rows.push_back({entry.id,
+                            proj.name,
+                            proj.lang,
+                            HumanSize(proj.size),
+                            purgeAt <= now ? "purge pending" : "purge at " + timeToString(purgeAt)});
+        }
+        Canvas::PrintTable(" Trash ", {"Id", "Name", "Language", "Size", "Status"}, rows, Canvas::Color::CYAN);
+        if (overdue)
+            Trash::SpawnPurger(projectRoots);
+    }
+
+    // Restore a trashed project by trash id or project name and put it back in the DevMap.
+    inline bool UndoTrash(const std::string &idOrName)
+    {
+        for (const auto &entry : Trash::List(projectRoots))
+        {
+            if (entry.purging && entry.id != idOrName)
+                continue;
+            Project proj = ProjectFromJson(entry.meta.value("project", nlohmann::json::object()));
+            if (entry.id != idOrName && proj.name != idOrName)
+                continue;
+
+            if (findProjectByName(projects, proj.name) != nullptr)
+            {
+                Canvas::PrintError("A project named '" + proj.name + "' exists again, rename it before restoring.");
+                return false;
+            }
+            std::string error;
+            if (!Trash::Restore(entry, error))
+            {
+                Canvas::PrintError(error);
+                return false;
+            }
+
+            std::vector<nlohmann::json> records;
+            if (std::find(languages.begin(), languages.end(), proj.lang) == languages.end())
+                records.push_back(AddLangRecord(proj.lang));
+            records.push_back(PutProjectRecord(proj));
+            Commit(records);
+            Canvas::PrintSuccess("Restored '" + proj.name + "' to " + Canvas::LinkText((proj.archived ? proj.archive : ProjectPath(proj)).string()));
+            return true;
+        }
+        Canvas::PrintError("No trash entry '" + idOrName + "'.");
+        return false;
+    }
+
+    // Purge the whole trash right away, in the foreground.
+    inline void PurgeTrash()
+    {
+        size_t purged = Trash::PurgeDue(projectRoots, true);
+        Canvas::PrintSuccess("Purged " + std::to_string(purged) + " trash " + (purged == 1 ? "entry." : "entries."));
+    }
+
+    // Delete a project: it is moved to the trash of its root and purged in the background.
+    // An archived project only exists as its archive file, which is what goes to the trash then;
+    // undoing it brings back the archived project.
+    // `trashId` is set to the trash entry, or left empty if the project had to be removed in place.
+    inline bool DeleteProject(const std::string &projectName, std::string &trashId)
+    {
+        const Project *found = findProjectByName(projects, projectName);
+        if (found == nullptr || (!found->archived && !fs::exists(ProjectPath(*found))))
+        {
+            Canvas::PrintError("You tried to delete '" + projectName + "'. No such project exists");
+            return false;
+        }
+        Project project = *found;
+        fs::path projPath = project.archived ? project.archive : ProjectPath(project);
+
+        // Move the project into the trash, the actual unlinking happens in the background.
+        // An archived project whose archive file is already gone only leaves the DevMap.
+        std::string error;
+        if (fs::exists(projPath))
+            trashId = Trash::MoveToTrash(project.root, projPath, {{"project", ProjectToJson(project)}}, TrashGrace(), error);
+        if (trashId.empty() && fs::exists(projPath))
+        {
+            // The trash is unusable (e.g. the language folder is a different mount), delete in place.
+            Canvas::PrintWarning("Cannot move the project to the trash: " + error + " Deleting it directly.");
+            std::error_code ec;
+            auto removedCount = fs::remove_all(projPath, ec);
+            if (ec)
+            {
+                Canvas::PrintError("Failed to delete project directory '" + Canvas::LinkText(projPath.string(), Canvas::Color::RED) + "'. Error: " + ec.message());
+                return false;
+            }
+            Canvas::PrintInfo("Deleted " + std::to_string(removedCount) + " items from " + Canvas::LinkText(projPath.string()));
+        }
+
+        // Remove the project from the projects vector and its entry from the DevMap.
+        projects.erase(std::remove_if(projects.begin(), projects.end(),
+            [&](const Project &p) { return ProjectPath(p) == ProjectPath(project); }),
+            projects.end());
+        Commit({RemoveProjectRecord(project)});
+
+        if (!trashId.empty())
+            Trash::SpawnPurger(projectRoots);
+        return true;
+    }
+
     inline void DeleteProjectWizard()
     {
         // Clear the console and print a vibrant title.
@@ -922,26 +2888,15 @@ namespace DevMap
         // 1. List projects and ask for the project name to delete.
         ListProjects(true);
         std::string projectName = Canvas::GetStringInput(u8"👉 Please enter the project name you want to delete: ", "", Canvas::Color::CYAN);
-        
-        Project project;
-        bool found = false;
-        for (auto &proj : projects)
-        {
-            if (proj.name == projectName)
-            {
-                found = true;
-                project = proj;
-                break; // Exit loop once the project is found.
-            }
-        }
 
-        if (!found || !fs::exists(projectsPath / project.lang / project.folderName))
+        const Project *project = findProjectByName(projects, projectName);
+        if (project == nullptr || (!project->archived && !fs::exists(ProjectPath(*project))))
         {
             Canvas::PrintErrorExit("You tried to delete '" + projectName + "'. No such project exists");
         }
 
-        fs::path projPath = projectsPath / project.lang / project.folderName;
-        
+        fs::path projPath = project->archived ? project->archive : ProjectPath(*project);
+
         // 2. Confirm deletion with the user.
         Canvas::ClearConsole();
         bool confirmation1 = Canvas::GetBoolInput(u8"🔥 Are you absolutely sure you want to delete '" + projectName + "' located at '" + Canvas::LinkText(projPath.string(), Canvas::Color::RED) + "'?", "Delete Project Confirmation 1", Canvas::Color::RED);
@@ -950,51 +2905,14 @@ namespace DevMap
 
         if (confirmation1 && confirmation2)
         {
-            // 3. Attempt to delete the project directory recursively.
-            std::error_code ec;
-            auto removedCount = fs::remove_all(projPath, ec);
-            if (ec)
-            {
-                Canvas::PrintError("Failed to delete project directory '" + Canvas::LinkText(projPath.string(), Canvas::Color::RED) + "'. Error: " + ec.message());
+            // 3. Move it to the trash and drop it from the DevMap.
+            std::string trashId;
+            if (!DeleteProject(projectName, trashId))
                 return;
-            }
-            else
-            {
-                Canvas::PrintInfo("Deleted " + std::to_string(removedCount) + " items from " + Canvas::LinkText(projPath.string()));
-            }
-
-            // 4. Remove the project from the projects vector.
-            projects.erase(std::remove_if(projects.begin(), projects.end(),
-                [&](const Project &p) { return p.name == projectName && p.lang == project.lang; }),
-                projects.end());
 
-            // 5. Update the devmapData JSON: remove the project entry.
-            if (devmapData.contains("Projects") && devmapData["Projects"].is_array())
-            {
-                nlohmann::json newProjects = nlohmann::json::array();
-                for (auto &projJson : devmapData["Projects"])
-                {
-                    if (projJson.value("name", "") != projectName)
-                    {
-                        newProjects.push_back(projJson);
-                    }
-                }
-                devmapData["Projects"] = newProjects;
-
-                // Write the updated JSON back to the file.
-                std::ofstream outFile(devmapFileName);
-                if (outFile.is_open())
-                {
-                    outFile << devmapData.dump(4); // Pretty-print with indentations.
-                    outFile.close();
-                }
-                else
-                {
-                    Canvas::PrintError("Unable to write updated DevMap to: " + devmapFileName.string());
-                }
-            }
-            
-            Canvas::PrintSuccess(u8"✅ Project '" + project.name + "' deleted successfully!");
+            Canvas::PrintSuccess(u8"✅ Project '" + projectName + "' deleted successfully!");
+            if (!trashId.empty())
+                Canvas::PrintInfo("It can be restored with 'devcore trash undo " + trashId + "' until " + timeToString(std::time(nullptr) + TrashGrace()) + ".");
         }
         else
         {
@@ -1002,7 +2920,57 @@ namespace DevMap
         }
     }
 
-    inline void RemoveTemplate()
+    // Open a project in the configured editor. `devcore open` does not sync the DevMap first, so
+    // it only does so here when the project is missing from it or no longer on disk.
+    inline bool OpenProject(const std::string &projectName)
+    {
+        const Project *project = findProjectByName(projects, projectName);
+        if (project == nullptr || !fs::is_directory(ProjectPath(*project)))
+        {
+            syncDevMap();
+            project = findProjectByName(projects, projectName);
+        }
+        if (project == nullptr || !fs::is_directory(ProjectPath(*project)))
+        {
+            Canvas::PrintError("You tried to open '" + projectName + "'. No such project exists");
+            return false;
+        }
+
+        std::string editor = Config::get("editor");
+        if (std::system((editor + " " + ShellQuote(ProjectPath(*project).string())).c_str()) != 0)
+        {
+            Canvas::PrintError(u8"❌ Failed to open the project with '" + editor + "', make sure it is installed and added to your PATH.");
+            return false;
+        }
+        Jump::Visit(ProjectPath(*project).string());
+        return true;
+    }
+
+    // Delete a template given as "<lang>/<name>".
+    inline bool RemoveTemplate(const std::string &templateDir)
+    {
+        std::vector<std::string> names = TemplateNames();
+        if (std::find(names.begin(), names.end(), templateDir) == names.end())
+        {
+            Canvas::PrintError("No template '" + templateDir + "', templates are named <lang>/<name>.");
+            return false;
+        }
+
+        fs::path delDir = fs::path(Main::HOME_PATH + Main::TEMPLATE_PATH) / templateDir;
+        std::error_code ec;
+        auto removedCount = fs::remove_all(delDir, ec);
+        if (ec)
+        {
+            Canvas::PrintError("Failed to delete template directory '" + Canvas::LinkText(delDir.string(), Canvas::Color::RED) + "'. Error: " + ec.message());
+            return false;
+        }
+        Canvas::PrintInfo("Deleted " + std::to_string(removedCount) + " items from " + Canvas::LinkText(delDir.string()));
+
+        WriteNameIndex();
+        return true;
+    }
+
+    inline void RemoveTemplateWizard()
     {
         Canvas::ClearConsole();
         ListTemplates();
@@ -1016,29 +2984,57 @@ namespace DevMap
 
         if (confirmation1 && confirmation2)
         {
-            // 3. Attempt to delete the project directory recursively.
-            std::error_code ec;
-            auto removedCount = fs::remove_all(delDir, ec);
-            if (ec)
-            {
-                Canvas::PrintError("Failed to delete template directory '" + Canvas::LinkText(delDir, Canvas::Color::RED) + "'. Error: " + ec.message());
-                return;
-            }
-            else
-            {
-                Canvas::PrintInfo("Deleted " + std::to_string(removedCount) + " items from " + Canvas::LinkText(delDir));
-            }
-
-            Canvas::PrintSuccess(u8"✅ Template '" + templateDir + "' deleted successfully!");
+            if (RemoveTemplate(templateDir))
+                Canvas::PrintSuccess(u8"✅ Template '" + templateDir + "' deleted successfully!");
         }
         else
         {
-            Canvas::PrintInfo(u8"Project deletion aborted.");
+            Canvas::PrintInfo(u8"Template deletion aborted.");
+        }
+
+    }
+
+    // Copy a directory into the templates as "<lang>/<name>" and write its manifest.
+    // The language is created when it does not exist yet.
+    inline bool AddTemplate(const std::string &name, const std::string &lang, const fs::path &source)
+    {
+        if (!ValidComponent(name))
+        {
+            Canvas::PrintError("Invalid template name '" + name + "'.");
+            return false;
+        }
+        if (!fs::is_directory(source))
+        {
+            Canvas::PrintError("Template source '" + source.string() + "' is not a directory.");
+            return false;
+        }
+        if (std::find(languages.begin(), languages.end(), lang) == languages.end() && !CreateLang(lang))
+            return false;
+
+        // Construct the target directory path
+        fs::path targetDir = fs::path(Main::HOME_PATH + Main::TEMPLATE_PATH) / lang / name;
+
+        // Copy the contents of the source directory into the target directory.
+        std::error_code ec;
+        fs::create_directories(targetDir, ec);
+        if (!ec)
+            fs::copy(source, targetDir, fs::copy_options::recursive | fs::copy_options::overwrite_existing | fs::copy_options::copy_symlinks, ec);
+        if (ec)
+        {
+            Canvas::PrintError("Failed to copy the template: " + ec.message());
+            return false;
         }
 
+        // Describe the template once, so creating projects from it needs no directory walk.
+        Template::Manifest manifest = Template::BuildManifest(targetDir);
+        Template::WriteManifest(targetDir, manifest);
+        WriteNameIndex();
+
+        Canvas::PrintInfo("Template manifest written: " + std::to_string(manifest.files.size()) + " files, " + HumanSize(manifest.totalSize) + ".");
+        return true;
     }
 
-    inline void AddTemplate()
+    inline void AddTemplateWizard()
     {
         Canvas::ClearConsole();
         std::string name = Canvas::GetStringInput(u8"👉 Please enter a template name: ", "", Canvas::Color::CYAN);
@@ -1048,30 +3044,15 @@ namespace DevMap
         if (std::find(languages.begin(), languages.end(), lang) == languages.end())
         {
             Canvas::PrintWarning("The language does not exist yet, would you like to create it?");
-            if (Canvas::GetBoolInput("   "))
-            {
-                CreateLang(lang);
-            }
-            else
+            if (!Canvas::GetBoolInput("   "))
             {
                 Canvas::PrintInfo("Aborting template addition.");
                 return;
             }
         }
 
-        // Construct the target directory path
-        std::string targetDir = Main::HOME_PATH + Main::TEMPLATE_PATH + lang + "/" + name;
-        
-        // Create the target directory if it doesn't exist
-        std::string mkdirCommand = "mkdir -p " + targetDir;
-        system(mkdirCommand.c_str());
-
-        // Copy the contents of the source directory into the target directory
-        // Using '/*' to copy the contents rather than the directory itself
-        std::string copyCommand = "cp -r " + source + "/* " + targetDir;
-        system(copyCommand.c_str());
-
-        Canvas::PrintSuccess("Succesfully added your template to the " + Canvas::LinkText(".config/devcore/templates", Canvas::Color::GREEN) + " directory.");
+        if (AddTemplate(name, lang, source))
+            Canvas::PrintSuccess("Succesfully added your template to the " + Canvas::LinkText(".config/devcore/templates", Canvas::Color::GREEN) + " directory.");
     }
 
 
@@ -0,0 +1,131 @@
+#ifndef FSUTIL_HPP
+#define FSUTIL_HPP
+
+#include "Scanner.hpp"
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace FsUtil
+{
+    // Outcome of removing (or measuring) a directory tree.
+    struct RemoveResult
+    {
+        size_t bytes = 0;   // Bytes freed, counted with the configured size mode.
+        size_t entries = 0; // Files and directories removed.
+        bool ok = true;     // False if anything could not be removed.
+    };
+
+    // Fill buf from fd, only stopping short at the end of the file, so chunk boundaries (and
+    // therefore the chained hash) never depend on how the kernel splits reads.
+    inline ssize_t ReadFull(int fd, char *buf, size_t length)
+    {
+        size_t got = 0;
+        while (got < length)
+        {
+            ssize_t n = read(fd, buf + got, length - got);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                return -1;
+            if (n == 0)
+                break;
+            got += static_cast<size_t>(n);
+        }
+        return static_cast<ssize_t>(got);
+    }
+
+    // Replace a file through a temporary one next to it, so a reader never sees it half written.
+    // `write(file)` fills the temporary file, it is renamed over `path` only if every write went
+    // through. The temporary name carries the pid, two processes saving at once never mix lines.
+    template <typename Write>
+    inline bool WriteAtomic(const fs::path &path, Write write)
+    {
+        std::string tmp = path.string() + "." + std::to_string(getpid()) + ".tmp";
+        FILE *file = fopen(tmp.c_str(), "w");
+        if (!file)
+            return false;
+        write(file);
+        bool ok = !ferror(file);
+        ok = fclose(file) == 0 && ok;
+        if (ok && rename(tmp.c_str(), path.c_str()) == 0)
+            return true;
+        unlink(tmp.c_str());
+        return false;
+    }
+
+    // Remove `name` inside the directory `parentFd`, recursing through directory fds with
+    // openat/unlinkat so no path is ever resolved twice and symlinks are never followed.
+    // Only regular files count towards the freed bytes, like in the scanner, and files that still
+    // have other hard links free nothing so they are not counted either.
+    // With dryRun set the tree is only measured.
+    inline void RemoveAt(int parentFd, const char *name, RemoveResult &result, bool dryRun = false)
+    {
+        struct stat st;
+        if (fstatat(parentFd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            result.ok = false;
+            return;
+        }
+
+        if (S_ISDIR(st.st_mode))
+        {
+            int fd = openat(parentFd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            DIR *handle = fd >= 0 ? fdopendir(fd) : nullptr;
+            if (!handle)
+            {
+                if (fd >= 0)
+                    close(fd);
+                result.ok = false;
+                return;
+            }
+            while (struct dirent *entry = readdir(handle))
+            {
+                const char *child = entry->d_name;
+                if (child[0] == '.' && (child[1] == '\0' || (child[1] == '.' && child[2] == '\0')))
+                    continue;
+                RemoveAt(dirfd(handle), child, result, dryRun);
+            }
+            closedir(handle);
+            if (!dryRun && unlinkat(parentFd, name, AT_REMOVEDIR) != 0)
+            {
+                result.ok = false;
+                return;
+            }
+        }
+        else
+        {
+            if (st.st_nlink <= 1 && S_ISREG(st.st_mode))
+                result.bytes += Scanner::FileBytes(st);
+            if (!dryRun && unlinkat(parentFd, name, 0) != 0)
+            {
+                result.ok = false;
+                return;
+            }
+        }
+        result.entries++;
+    }
+
+    // Remove a file or directory tree by path.
+    inline RemoveResult RemoveTree(const fs::path &path, bool dryRun = false)
+    {
+        RemoveResult result;
+        fs::path parent = path.parent_path();
+        int parentFd = open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (parentFd < 0)
+        {
+            result.ok = false;
+            return result;
+        }
+        RemoveAt(parentFd, path.filename().c_str(), result, dryRun);
+        close(parentFd);
+        return result;
+    }
+} // namespace FsUtil
+
+#endif // FSUTIL_HPP
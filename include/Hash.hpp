@@ -0,0 +1,85 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <cstring>
+
+namespace Hash
+{
+    // CRC-32 (IEEE 802.3) lookup table, built once at compile time.
+    constexpr std::array<uint32_t, 256> MakeCrc32Table()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<uint32_t, 256> crc32Table = MakeCrc32Table();
+
+    // CRC-32 checksum of a buffer, used to detect torn or corrupted records.
+    inline uint32_t Crc32(const void *data, size_t length, uint32_t crc = 0)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        crc = ~crc;
+        for (size_t i = 0; i < length; i++)
+            crc = crc32Table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    inline uint32_t Crc32(const std::string &data)
+    {
+        return Crc32(data.data(), data.size());
+    }
+
+    // MurmurHash64A, a fast 64-bit content hash working on 8 bytes at a time.
+    // Large inputs are hashed chunk by chunk by passing the previous result as the seed.
+    // Not collision resistant, callers that act on equal hashes must compare the bytes.
+    inline uint64_t Murmur64(const void *data, size_t length, uint64_t seed = 0)
+    {
+        const uint64_t m = 0xc6a4a7935bd1e995ULL;
+        const int r = 47;
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        uint64_t h = seed ^ (length * m);
+
+        size_t blocks = length / 8;
+        for (size_t i = 0; i < blocks; i++)
+        {
+            uint64_t k;
+            std::memcpy(&k, bytes + i * 8, sizeof(k));
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+            h ^= k;
+            h *= m;
+        }
+
+        const unsigned char *tail = bytes + blocks * 8;
+        switch (length & 7)
+        {
+        case 7: h ^= uint64_t(tail[6]) << 48; [[fallthrough]];
+        case 6: h ^= uint64_t(tail[5]) << 40; [[fallthrough]];
+        case 5: h ^= uint64_t(tail[4]) << 32; [[fallthrough]];
+        case 4: h ^= uint64_t(tail[3]) << 24; [[fallthrough]];
+        case 3: h ^= uint64_t(tail[2]) << 16; [[fallthrough]];
+        case 2: h ^= uint64_t(tail[1]) << 8; [[fallthrough]];
+        case 1: h ^= uint64_t(tail[0]);
+                h *= m;
+        }
+
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+        return h;
+    }
+} // namespace Hash
+
+#endif // HASH_HPP
@@ -0,0 +1,127 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include "Hash.hpp"
+#include <string>
+#include <vector>
+#include <functional>
+#include <filesystem>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+namespace fs = std::filesystem;
+
+// Append-only journal of DevMap mutations.
+// Every record is one line: "<crc32 as 8 hex digits> <compact json>\n".
+// The snapshot (devmap.json) plus the journal replayed on top of it is the current DevMap,
+// so a single change costs one small append instead of rewriting the whole file.
+namespace Journal
+{
+    // Once the journal grows past this size it is folded back into the snapshot.
+    const size_t COMPACT_THRESHOLD = 256 * 1024;
+
+    // The journal lives next to the snapshot: devmap.json -> devmap.journal.
+    inline fs::path PathFor(const fs::path &snapshot)
+    {
+        return fs::path(snapshot).replace_extension(".journal");
+    }
+
+    inline std::string Encode(const nlohmann::json &record)
+    {
+        std::string payload = record.dump();
+        char checksum[10];
+        std::snprintf(checksum, sizeof(checksum), "%08x ", Hash::Crc32(payload));
+        return checksum + payload + "\n";
+    }
+
+    // Append records with a single write so concurrent readers never see half a batch.
+    inline bool Append(const fs::path &journal, const std::vector<nlohmann::json> &records)
+    {
+        if (records.empty())
+            return true;
+        std::string data;
+        for (const auto &record : records)
+            data += Encode(record);
+
+        int fd = open(journal.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return false;
+        const char *ptr = data.data();
+        size_t left = data.size();
+        while (left > 0)
+        {
+            ssize_t written = write(fd, ptr, left);
+            if (written < 0)
+            {
+                close(fd);
+                return false;
+            }
+            ptr += written;
+            left -= static_cast<size_t>(written);
+        }
+        close(fd);
+        return true;
+    }
+
+    // Replay every valid record starting at byte offset `from` and return the offset just past
+    // the last valid one. Replay stops at the first record with a bad checksum, which is what a
+    // torn write after a crash looks like.
+    inline size_t Replay(const fs::path &journal, const std::function<void(const nlohmann::json &)> &apply, size_t from = 0)
+    {
+        FILE *file = fopen(journal.c_str(), "rb");
+        if (!file)
+            return from;
+        if (from > 0 && fseek(file, static_cast<long>(from), SEEK_SET) != 0)
+        {
+            fclose(file);
+            return from;
+        }
+        std::string data;
+        char chunk[65536];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+            data.append(chunk, n);
+        fclose(file);
+
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            size_t end = data.find('\n', pos);
+            if (end == std::string::npos || end - pos < 10 || data[pos + 8] != ' ')
+                break;
+            std::string payload = data.substr(pos + 9, end - pos - 9);
+            unsigned long checksum = std::strtoul(data.substr(pos, 8).c_str(), nullptr, 16);
+            if (checksum != Hash::Crc32(payload))
+                break;
+            nlohmann::json record = nlohmann::json::parse(payload, nullptr, false);
+            if (record.is_discarded())
+                break;
+            apply(record);
+            pos = end + 1;
+        }
+        return from + pos;
+    }
+
+    inline size_t Size(const fs::path &journal)
+    {
+        std::error_code ec;
+        auto size = fs::file_size(journal, ec);
+        return ec ? 0 : static_cast<size_t>(size);
+    }
+
+    // Drop a torn tail so later appends are not hidden behind it.
+    inline void Truncate(const fs::path &journal, size_t validSize)
+    {
+        if (Size(journal) > validSize)
+            truncate(journal.c_str(), static_cast<off_t>(validSize));
+    }
+
+    inline void Clear(const fs::path &journal)
+    {
+        std::error_code ec;
+        fs::remove(journal, ec);
+    }
+} // namespace Journal
+
+#endif // JOURNAL_HPP
@@ -0,0 +1,231 @@
+#ifndef JUMP_HPP
+#define JUMP_HPP
+
+#include "Complete.hpp"
+#include "Main.hpp"
+#include "FsUtil.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Frecency ranked project jumping: `devcore jump <fragment>...` and `devcore jump --add <dir>`.
+// Like completion it runs before the config and the DevMap are loaded. Visits are counted in a
+// small store of "<rank> <last visit> <path>" lines, a project's score is its rank weighted by
+// how recently it was visited. Project paths come from the name index ("d" lines), so every
+// project can be jumped to before its first visit, and a visit to a folder inside a project
+// counts for the project.
+// The store is replaced by rename, never locked: two shells saving at once lose one visit at worst.
+namespace Jump
+{
+    const double MAX_TOTAL = 10000; // Ranks are aged once they add up to more than this.
+
+    struct Entry
+    {
+        std::string path;
+        double rank = 0;
+        long long last = 0;
+    };
+
+    inline std::string StorePath()
+    {
+        return Main::HOME_PATH + Main::FRECENCY_PATH;
+    }
+
+    // Rank weighted by the time since the last visit.
+    inline double Score(const Entry &entry, long long now)
+    {
+        long long age = now - entry.last;
+        if (age < 3600)
+            return entry.rank * 4;
+        if (age < 86400)
+            return entry.rank * 2;
+        if (age < 604800)
+            return entry.rank / 2;
+        return entry.rank / 4;
+    }
+
+    inline std::vector<Entry> Load()
+    {
+        std::vector<Entry> entries;
+        FILE *file = fopen(StorePath().c_str(), "r");
+        if (!file)
+            return entries;
+        double rank;
+        long long last;
+        char path[4096];
+        while (std::fscanf(file, "%lf %lld %4095[^\n]", &rank, &last, path) == 3)
+            entries.push_back({path, rank, last});
+        fclose(file);
+        return entries;
+    }
+
+    inline void Save(const std::vector<Entry> &entries)
+    {
+        FsUtil::WriteAtomic(StorePath(), [&](FILE *file) {
+            for (const auto &entry : entries)
+                std::fprintf(file, "%.3f %lld %s\n", entry.rank, entry.last, entry.path.c_str());
+        });
+    }
+
+    // Count a visit to a project. Once the ranks add up to more than MAX_TOTAL they are all
+    // scaled down, entries that fall below one visit are forgotten.
+    inline void Visit(const std::string &projectPath)
+    {
+        std::vector<Entry> entries = Load();
+        auto found = std::find_if(entries.begin(), entries.end(), [&](const Entry &entry) { return entry.path == projectPath; });
+        if (found == entries.end())
+            found = entries.insert(entries.end(), {projectPath, 0, 0});
+        found->rank += 1;
+        found->last = static_cast<long long>(std::time(nullptr));
+
+        double total = 0;
+        for (const auto &entry : entries)
+            total += entry.rank;
+        if (total > MAX_TOTAL)
+        {
+            double factor = 0.9 * MAX_TOTAL / total;
+            for (auto &entry : entries)
+                entry.rank *= factor;
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry &entry) { return entry.rank < 1; }), entries.end());
+        }
+        Save(entries);
+    }
+
+    // The project a folder belongs to: the longest project path it is or lies in, "" if none.
+    inline std::string ProjectOf(const std::vector<std::string_view> &projectPaths, std::string_view dir)
+    {
+        std::string_view best;
+        for (std::string_view path : projectPaths)
+        {
+            bool inside = dir.size() == path.size() || (dir.size() > path.size() && dir[path.size()] == '/');
+            if (path.size() > best.size() && inside && dir.compare(0, path.size(), path) == 0)
+                best = path;
+        }
+        return std::string(best);
+    }
+
+    inline std::string Lower(std::string_view text)
+    {
+        std::string lower(text);
+        for (char &c : lower)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return lower;
+    }
+
+    // Whether the fragments (lower case) appear in the path in order, the last one in its final
+    // component, so `jump api` finds .../api-server and not every project below a folder "api".
+    inline bool Matches(std::string_view path, const std::vector<std::string> &fragments, std::string &lower)
+    {
+        // Most paths fail on the last fragment, which only needs the folder name lowered.
+        if (!fragments.empty())
+        {
+            size_t slash = path.rfind('/');
+            lower.assign(path.substr(slash == std::string_view::npos ? 0 : slash + 1));
+            for (char &c : lower)
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            if (lower.find(fragments.back()) == std::string::npos)
+                return false;
+        }
+        lower.assign(path);
+        for (char &c : lower)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        size_t at = 0;
+        for (size_t i = 0; i < fragments.size(); i++)
+        {
+            size_t found = i + 1 < fragments.size() ? lower.find(fragments[i], at) : lower.rfind(fragments[i]);
+            if (found == std::string::npos || found < at)
+                return false;
+            if (i + 1 == fragments.size() && lower.find('/', found + fragments[i].size()) != std::string::npos)
+                return false;
+            at = found + fragments[i].size();
+        }
+        return true;
+    }
+
+    inline bool IsDirectory(const std::string &path)
+    {
+        struct stat st;
+        return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    }
+
+    inline int Run(int argc, char const *argv[])
+    {
+        std::string buffer;
+        std::vector<std::string_view> projectPaths = Complete::ReadIndex('d', buffer);
+        std::vector<Entry> entries = Load();
+        long long now = static_cast<long long>(std::time(nullptr));
+
+        // --add <dir>: the shell hook reports every directory change.
+        if (argc == 4 && std::string(argv[2]) == "--add")
+        {
+            std::string project = ProjectOf(projectPaths, argv[3]);
+            if (!project.empty())
+                Visit(project);
+            return 0;
+        }
+
+        if (argc == 2)
+        {
+            std::sort(entries.begin(), entries.end(), [&](const Entry &a, const Entry &b) { return Score(a, now) > Score(b, now); });
+            for (const auto &entry : entries)
+                std::printf("%8.1f  %s\n", Score(entry, now), entry.path.c_str());
+            return 0;
+        }
+
+        std::vector<std::string> fragments;
+        for (int i = 2; i < argc; i++)
+        {
+            if (argv[i][0] != '\0')
+                fragments.push_back(Lower(argv[i]));
+        }
+
+        // Visited projects first by score, then the others from the name index.
+        std::vector<std::pair<double, std::string>> candidates;
+        std::set<std::string, std::less<>> visited;
+        std::string lower;
+        for (const auto &entry : entries)
+        {
+            visited.insert(entry.path);
+            if (Matches(entry.path, fragments, lower))
+                candidates.push_back({Score(entry, now), entry.path});
+        }
+        for (std::string_view path : projectPaths)
+        {
+            if (Matches(path, fragments, lower) && visited.find(path) == visited.end())
+                candidates.push_back({0, std::string(path)});
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) {
+            return a.first != b.first ? a.first > b.first : a.second.size() < b.second.size();
+        });
+
+        // The current project is only the answer when nothing else matches.
+        const char *pwd = std::getenv("PWD");
+        std::string current = pwd ? ProjectOf(projectPaths, pwd) : "";
+        if (candidates.size() > 1 && candidates[0].second == current)
+            std::rotate(candidates.begin(), candidates.begin() + 1, candidates.end());
+
+        for (const auto &[score, path] : candidates)
+        {
+            if (!IsDirectory(path))
+                continue;
+            Visit(path);
+            std::printf("%s\n", path.c_str());
+            return 0;
+        }
+        std::string query;
+        for (const auto &fragment : fragments)
+            query += (query.empty() ? "" : " ") + fragment;
+        std::fprintf(stderr, "devcore jump: no project matches '%s'\n", query.c_str());
+        return 1;
+    }
+} // namespace Jump
+
+#endif // JUMP_HPP
@@ -0,0 +1,55 @@
+#ifndef LOCK_HPP
+#define LOCK_HPP
+
+#include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+namespace fs = std::filesystem;
+
+namespace Lock
+{
+    // RAII advisory lock on a directory (flock on a directory fd).
+    // Readers take a shared lock, writers an exclusive one. Locks are released when the guard
+    // goes out of scope, or by the kernel when the process dies, so a crash never leaves a stale lock.
+    // Guards must not be nested within one process: flock locks belong to the open file, so two
+    // guards on the same directory would wait on each other.
+    class Guard
+    {
+    public:
+        Guard(const fs::path &directory, bool exclusive)
+        {
+            fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0)
+                return;
+            while (flock(fd, exclusive ? LOCK_EX : LOCK_SH) != 0)
+            {
+                if (errno != EINTR)
+                {
+                    close(fd);
+                    fd = -1;
+                    return;
+                }
+            }
+        }
+
+        ~Guard()
+        {
+            if (fd >= 0)
+            {
+                flock(fd, LOCK_UN);
+                close(fd);
+            }
+        }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+        bool Locked() const { return fd >= 0; }
+
+    private:
+        int fd = -1;
+    };
+} // namespace Lock
+
+#endif // LOCK_HPP
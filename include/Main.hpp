@@ -7,6 +7,14 @@ namespace Main
     const std::string TEMPLATE_PATH = "/.config/devcore/templates";
     const std::string CONFIG_PATH = "/.config/devcore/devcore.conf";
     const std::string DEVMAP_PATH = "/.config/devcore/devmap.json";
+    const std::string INDEX_PATH = "/.config/devcore/names.idx";
+    const std::string HASH_INDEX_PATH = "/.config/devcore/hashes.idx";
+    const std::string ARCHIVE_PATH = "/.config/devcore/archive/";
+    const std::string BUILD_LOG_PATH = "/.config/devcore/build/";
+    const std::string DEPS_CACHE_PATH = "/.config/devcore/deps.cache";
+    const std::string STATS_CACHE_PATH = "/.config/devcore/stats.cache";
+    const std::string SKETCH_INDEX_PATH = "/.config/devcore/sketches.idx";
+    const std::string FRECENCY_PATH = "/.config/devcore/frecency.idx";
     const std::string HOME_PATH = getenv("HOME");
 }
 
@@ -0,0 +1,47 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace Parallel
+{
+    // Number of hardware threads, never less than one.
+    inline size_t HardwareThreads()
+    {
+        unsigned int n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    // Run fn(i) for every i in [0, count) on at most `workers` threads.
+    // Work is handed out one index at a time, so slow items do not stall the others.
+    inline void ForEach(size_t count, size_t workers, const std::function<void(size_t)> &fn)
+    {
+        workers = std::max<size_t>(1, std::min(workers, count));
+        if (workers <= 1)
+        {
+            for (size_t i = 0; i < count; i++)
+                fn(i);
+            return;
+        }
+
+        std::atomic<size_t> next{0};
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (size_t w = 0; w < workers; w++)
+        {
+            threads.emplace_back([&]() {
+                for (size_t i = next++; i < count; i = next++)
+                    fn(i);
+            });
+        }
+        for (auto &t : threads)
+            t.join();
+    }
+} // namespace Parallel
+
+#endif // PARALLEL_HPP
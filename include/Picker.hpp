@@ -0,0 +1,370 @@
+#ifndef PICKER_HPP
+#define PICKER_HPP
+
+#include "Screen.hpp"
+#include "Watch.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <poll.h>
+
+// Interactive fuzzy selection, used by `devcore open`.
+// The query matches a name when its characters appear in it in order (case-insensitive), matches
+// are ranked by how well the characters line up: at word starts and next to each other beats
+// scattered over the name. Every query keeps the matches of the query it grew from, so a typed
+// character only re-ranks what still matched before and a backspace costs nothing at all.
+namespace Picker
+{
+    const size_t MAX_NAME = 256; // Longer names are matched on their first MAX_NAME bytes.
+
+    const int MATCH = 16;       // Every matched character.
+    const int BOUNDARY = 10;    // Matched at the start of the name or of a word.
+    const int CAMEL = 8;        // Matched at an upper case letter after a lower case one.
+    const int CONSECUTIVE = 12; // Matched right after the previous query character.
+    const int GAP = 1;          // Every character skipped between two matched ones.
+
+    inline std::string Lower(const std::string &text)
+    {
+        std::string lower = text;
+        for (char &c : lower)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return lower;
+    }
+
+    // Scores the best alignment of a query in a name. The table is kept between calls, scoring
+    // ten thousand names allocates nothing after the first.
+    class Matcher
+    {
+    public:
+        // Score of `query` (lower case) in `name`, or -1 if it does not match. `positions`
+        // receives the offsets of the matched bytes if given.
+        int Score(const std::string &query, const std::string &name, const std::string &lower, std::vector<size_t> *positions = nullptr)
+        {
+            size_t n = query.size();
+            size_t m = std::min(lower.size(), MAX_NAME);
+            if (n == 0)
+                return 0;
+
+            // Cheap subsequence test first, most names fail it.
+            size_t at = 0;
+            for (size_t i = 0; i < n; i++, at++)
+            {
+                while (at < m && lower[at] != query[i])
+                    at++;
+                if (at == m)
+                    return -1;
+            }
+
+            // table[i * m + j]: best score with query[i] matched at name[j], from: where query[i - 1] was.
+            const int NONE = INT_MIN / 2;
+            table.assign(n * m, NONE);
+            from.assign(n * m, 0);
+            for (size_t i = 0; i < n; i++)
+            {
+                int run = NONE; // Best table[i - 1][k] + GAP * k over k <= j - 2.
+                size_t runAt = 0;
+                for (size_t j = i; j < m; j++)
+                {
+                    if (i > 0 && j >= 2 && table[(i - 1) * m + j - 2] != NONE && table[(i - 1) * m + j - 2] + GAP * static_cast<int>(j - 2) > run)
+                    {
+                        run = table[(i - 1) * m + j - 2] + GAP * static_cast<int>(j - 2);
+                        runAt = j - 2;
+                    }
+                    if (lower[j] != query[i])
+                        continue;
+                    int bonus = MATCH + Bonus(name, j);
+                    if (i == 0)
+                    {
+                        table[j] = bonus;
+                        continue;
+                    }
+                    int best = NONE;
+                    if (table[(i - 1) * m + j - 1] != NONE)
+                    {
+                        best = table[(i - 1) * m + j - 1] + CONSECUTIVE;
+                        from[i * m + j] = j - 1;
+                    }
+                    if (run != NONE && run - GAP * static_cast<int>(j - 1) > best)
+                    {
+                        best = run - GAP * static_cast<int>(j - 1);
+                        from[i * m + j] = runAt;
+                    }
+                    if (best != NONE)
+                        table[i * m + j] = best + bonus;
+                }
+            }
+
+            size_t end = 0;
+            int score = NONE;
+            for (size_t j = n - 1; j < m; j++)
+            {
+                if (table[(n - 1) * m + j] > score)
+                {
+                    score = table[(n - 1) * m + j];
+                    end = j;
+                }
+            }
+            if (score == NONE)
+                return -1;
+            if (positions)
+            {
+                positions->assign(n, 0);
+                for (size_t i = n; i-- > 0;)
+                {
+                    (*positions)[i] = end;
+                    end = from[i * m + end];
+                }
+            }
+            return std::max(score, 0);
+        }
+
+    private:
+        static int Bonus(const std::string &name, size_t j)
+        {
+            if (j == 0)
+                return BOUNDARY;
+            char previous = name[j - 1];
+            if (previous == ' ' || previous == '-' || previous == '_' || previous == '.' || previous == '/')
+                return BOUNDARY;
+            if (std::islower(static_cast<unsigned char>(previous)) && std::isupper(static_cast<unsigned char>(name[j])))
+                return CAMEL;
+            return 0;
+        }
+
+        std::vector<int> table;
+        std::vector<size_t> from;
+    };
+
+    struct Ranked
+    {
+        int score = 0;
+        size_t index = 0;
+    };
+
+    // The names matching a query, best first, filtered from the matches of a shorter query.
+    inline std::vector<Ranked> Filter(Matcher &matcher, const std::string &query, const std::vector<std::string> &names, const std::vector<std::string> &lower, const std::vector<Ranked> &candidates)
+    {
+        std::vector<Ranked> matches;
+        matches.reserve(candidates.size());
+        for (const Ranked &candidate : candidates)
+        {
+            int score = matcher.Score(query, names[candidate.index], lower[candidate.index]);
+            if (score >= 0)
+                matches.push_back({score, candidate.index});
+        }
+        std::sort(matches.begin(), matches.end(), [&](const Ranked &a, const Ranked &b) {
+            if (a.score != b.score)
+                return a.score > b.score;
+            if (names[a.index].size() != names[b.index].size())
+                return names[a.index].size() < names[b.index].size();
+            return a.index < b.index;
+        });
+        return matches;
+    }
+
+    // Whether a picker can be shown, stdin and stdout both have to be a terminal. Embedded calls
+    // (a batch file, a host) never prompt, not even from a terminal.
+    inline bool Interactive()
+    {
+        return !Canvas::embedded && isatty(STDIN_FILENO) && isatty(STDOUT_FILENO);
+    }
+
+    // Let the user pick one of `names`, starting with `query` typed in. Returns false when the
+    // picker was cancelled (Esc, Ctrl-C, Ctrl-D) or could not be opened.
+    inline bool Pick(const std::string &title, const std::vector<std::string> &names, std::string query, std::string &chosen)
+    {
+        std::vector<std::string> lower;
+        lower.reserve(names.size());
+        for (const auto &name : names)
+            lower.push_back(Lower(name));
+
+        // levels[k] holds the matches of queries[k]; every query is a prefix of the next one.
+        std::vector<std::string> queries{""};
+        std::vector<std::vector<Ranked>> levels(1);
+        for (size_t i = 0; i < names.size(); i++)
+            levels[0].push_back({0, i});
+        Matcher matcher;
+        auto update = [&]() {
+            // A multi-byte character split over two reads is filtered once it is complete.
+            size_t lead = query.size();
+            while (lead > 0 && (static_cast<unsigned char>(query[lead - 1]) & 0xC0) == 0x80)
+                lead--;
+            if (lead > 0)
+            {
+                unsigned char first = static_cast<unsigned char>(query[lead - 1]);
+                size_t needed = first >= 0xF0 ? 4 : first >= 0xE0 ? 3 : first >= 0xC0 ? 2 : 1;
+                if (query.size() - (lead - 1) < needed)
+                    return;
+            }
+            std::string lowered = Lower(query);
+            while (lowered.compare(0, queries.back().size(), queries.back()) != 0)
+            {
+                queries.pop_back();
+                levels.pop_back();
+            }
+            if (queries.back() != lowered)
+            {
+                levels.push_back(Filter(matcher, lowered, names, lower, levels.back()));
+                queries.push_back(lowered);
+            }
+        };
+
+        Screen::Screen screen;
+        if (!Watch::CatchSignals() || !screen.Open())
+            return false;
+
+        size_t selected = 0, offset = 0;
+        std::vector<size_t> positions;
+        auto render = [&]() {
+            const std::vector<Ranked> &matches = levels.back();
+            size_t width = screen.Cols();
+            size_t height = screen.Rows();
+            size_t listRows = height > 3 ? height - 3 : 1;
+            if (selected >= matches.size())
+                selected = matches.empty() ? 0 : matches.size() - 1;
+            if (selected < offset)
+                offset = selected;
+            if (selected >= offset + listRows)
+                offset = selected - listRows + 1;
+
+            screen.Clear();
+            size_t col = screen.Put(0, 0, title, Canvas::Color::CYAN, true);
+            col += screen.Put(0, col, "❯ ", Canvas::Color::PINK, true);
+            col += screen.Put(0, col, query, Canvas::Color::DEFAULT, true);
+            screen.Put(0, col, "█", Canvas::Color::PINK);
+            std::string count = " " + std::to_string(matches.size()) + "/" + std::to_string(names.size()) + " ";
+            col = screen.Put(1, 0, count, Canvas::Color::CYAN);
+            screen.Fill(1, col, width - std::min(width, col), "─", Canvas::Color::CYAN);
+
+            for (size_t row = 0; row < listRows && offset + row < matches.size(); row++)
+            {
+                size_t index = matches[offset + row].index;
+                bool current = offset + row == selected;
+                if (current)
+                    screen.Put(row + 2, 0, "❯", Canvas::Color::PINK, true);
+                const std::string &name = names[index];
+                if (!queries.back().empty())
+                    matcher.Score(queries.back(), name, lower[index], &positions);
+                size_t next = 0;
+                col = 2;
+                for (size_t i = 0; i < name.size() && col < width;)
+                {
+                    bool matched = !queries.back().empty() && next < positions.size() && positions[next] == i;
+                    next += matched;
+                    size_t length = 1;
+                    while (i + length < name.size() && (static_cast<unsigned char>(name[i + length]) & 0xC0) == 0x80)
+                        length++;
+                    screen.Put(row + 2, col++, name.substr(i, length), matched ? Canvas::Color::YELLOW : Canvas::Color::DEFAULT, current || matched);
+                    i += length;
+                }
+            }
+            screen.Put(height - 1, 0, " ↑/↓ select  Enter open  Esc cancel", Canvas::Color::CYAN);
+            screen.Present();
+        };
+
+        update();
+        bool picked = false, running = true;
+        while (running)
+        {
+            render();
+            pollfd fds[2] = {{STDIN_FILENO, POLLIN, 0}, {Watch::signalPipe[0], POLLIN, 0}};
+            if (poll(fds, 2, -1) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            if (fds[1].revents & POLLIN)
+            {
+                char c;
+                while (read(Watch::signalPipe[0], &c, 1) == 1)
+                {
+                    if (c == 'q')
+                        running = false;
+                    else
+                        screen.Resize();
+                }
+            }
+            if (!(fds[0].revents & (POLLIN | POLLHUP)))
+                continue;
+
+            // Everything typed since the last frame is applied before filtering once, so a paste
+            // or a fast typist does not wait for a frame per character.
+            char buffer[256];
+            ssize_t length = read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (length <= 0)
+                break;
+            size_t page = screen.Rows() > 4 ? screen.Rows() - 4 : 1;
+            std::string typed = query;
+            for (ssize_t i = 0; i < length && running; i++)
+            {
+                unsigned char c = static_cast<unsigned char>(buffer[i]);
+                if (c == '\n' || c == '\r')
+                {
+                    if (query != typed)
+                        selected = 0;
+                    update();
+                    const std::vector<Ranked> &matches = levels.back();
+                    picked = !matches.empty();
+                    running = !picked;
+                    if (picked)
+                        chosen = names[matches[std::min(selected, matches.size() - 1)].index];
+                }
+                else if (c == 0x04 || (c == 0x1b && i + 1 == length))
+                    running = false;
+                else if (c == 0x1b)
+                {
+                    // Escape sequence: ESC [ or ESC O, parameters, one final byte.
+                    ssize_t end = i + 2;
+                    while (end < length && !(buffer[end] >= 0x40 && buffer[end] <= 0x7e))
+                        end++;
+                    char key = end < length ? buffer[end] : 0;
+                    std::string params(buffer + std::min<ssize_t>(i + 2, length), buffer + std::min<ssize_t>(end, length));
+                    if (key == 'A')
+                        selected = selected > 0 ? selected - 1 : 0;
+                    else if (key == 'B')
+                        selected++;
+                    else if (key == '~' && params == "5")
+                        selected = selected > page ? selected - page : 0;
+                    else if (key == '~' && params == "6")
+                        selected += page;
+                    i = end;
+                }
+                else if (c == 0x10)
+                    selected = selected > 0 ? selected - 1 : 0;
+                else if (c == 0x0e)
+                    selected++;
+                else if (c == 0x7f || c == 0x08)
+                {
+                    // Remove one UTF-8 character.
+                    while (!query.empty() && (static_cast<unsigned char>(query.back()) & 0xC0) == 0x80)
+                        query.pop_back();
+                    if (!query.empty())
+                        query.pop_back();
+                }
+                else if (c == 0x15)
+                    query.clear();
+                else if (c == 0x17)
+                {
+                    while (!query.empty() && query.back() == ' ')
+                        query.pop_back();
+                    while (!query.empty() && query.back() != ' ')
+                        query.pop_back();
+                }
+                else if (c >= 0x20)
+                    query.push_back(static_cast<char>(c));
+            }
+            if (query != typed)
+                selected = 0;
+            update();
+        }
+
+        screen.Close();
+        Watch::ReleaseSignals();
+        return picked;
+    }
+} // namespace Picker
+
+#endif // PICKER_HPP
@@ -0,0 +1,207 @@
+#ifndef SCANNER_HPP
+#define SCANNER_HPP
+
+#include "Parallel.hpp"
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+namespace fs = std::filesystem;
+
+namespace Scanner
+{
+    // Data gathered for a single project directory during a scan.
+    struct Result
+    {
+        size_t size = 0;      // Project size in bytes.
+        size_t gitSize = 0;   // Bytes inside the .git folder (included in size).
+        bool usesGit = false; // Wether there is a .git folder in the project.
+        time_t lastActivity = 0; // Newest modification time of any file, 0 for an empty project.
+    };
+
+    // A project directory to scan, together with the root it lives under.
+    // The root decides which device (and therefore which worker group) scans it.
+    struct Job
+    {
+        fs::path root;
+        fs::path path;
+        Result result;
+    };
+
+    // How file sizes are counted.
+    enum class SizeMode
+    {
+        Apparent,  // The length of each file (st_size).
+        Allocated  // The disk blocks actually in use (st_blocks), sparse files count what they occupy.
+    };
+
+    // Scan settings, filled from the configuration when the DevMap is loaded.
+    struct Options
+    {
+        SizeMode sizeMode = SizeMode::Apparent;
+        // Globs for paths that are skipped, excluded directories are not descended into at all.
+        // A glob without a '/' matches an entry name at any depth ("node_modules", "*.o"),
+        // a glob with a '/' matches the path relative to the project (".git/objects", "out/*").
+        std::vector<std::string> excludes;
+    };
+
+    inline Options options;
+
+    // Bytes a file accounts for under the configured size mode.
+    inline size_t FileBytes(const struct stat &st)
+    {
+        return options.sizeMode == SizeMode::Allocated ? static_cast<size_t>(st.st_blocks) * 512 : static_cast<size_t>(st.st_size);
+    }
+
+    inline bool IsExcluded(const std::string &relPath, const char *name)
+    {
+        for (const auto &glob : options.excludes)
+        {
+            bool anchored = glob.find('/') != std::string::npos;
+            if (anchored ? fnmatch(glob.c_str(), relPath.c_str(), FNM_PATHNAME) == 0
+                         : fnmatch(glob.c_str(), name, 0) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Walk a project directory once and collect its size and Git status.
+    // Directories are opened relative to the project with openat and entries are stat'ed with
+    // fstatat, so every file costs a single syscall. Files with several hard links are only
+    // counted once per project. The newest file mtime comes from the same fstatat call.
+    inline Result ScanProject(const fs::path &projectPath)
+    {
+        Result result;
+        int rootFd = open(projectPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (rootFd < 0)
+            return result;
+
+        struct stat gitStat;
+        result.usesGit = fstatat(rootFd, ".git", &gitStat, 0) == 0 && S_ISDIR(gitStat.st_mode);
+
+        struct Pending
+        {
+            std::string relPath; // Relative to the project, empty for the project itself.
+            bool inGit;          // Inside the top-level .git directory.
+        };
+        std::vector<Pending> stack{{"", false}};
+        std::set<std::pair<dev_t, ino_t>> seenLinks;
+
+        while (!stack.empty())
+        {
+            Pending dir = std::move(stack.back());
+            stack.pop_back();
+
+            int fd = dir.relPath.empty() ? dup(rootFd) : openat(rootFd, dir.relPath.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (fd < 0)
+                continue;
+            DIR *handle = fdopendir(fd);
+            if (!handle)
+            {
+                close(fd);
+                continue;
+            }
+
+            while (struct dirent *entry = readdir(handle))
+            {
+                const char *name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    continue;
+                std::string relPath = dir.relPath.empty() ? std::string(name) : dir.relPath + "/" + name;
+                if (IsExcluded(relPath, name))
+                    continue;
+
+                struct stat st;
+                if (fstatat(dirfd(handle), name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                    continue;
+
+                if (S_ISDIR(st.st_mode))
+                {
+                    stack.push_back({relPath, dir.inGit || (dir.relPath.empty() && std::strcmp(name, ".git") == 0)});
+                }
+                else if (S_ISREG(st.st_mode))
+                {
+                    if (st.st_mtime > result.lastActivity)
+                        result.lastActivity = st.st_mtime;
+                    if (st.st_nlink > 1 && !seenLinks.insert({st.st_dev, st.st_ino}).second)
+                        continue;
+                    size_t bytes = FileBytes(st);
+                    result.size += bytes;
+                    if (dir.inGit)
+                        result.gitSize += bytes;
+                }
+            }
+            closedir(handle);
+        }
+
+        close(rootFd);
+        return result;
+    }
+
+    // Device id of a path, or 0 if it cannot be stat'ed.
+    inline dev_t DeviceOf(const fs::path &path)
+    {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0)
+            return 0;
+        return st.st_dev;
+    }
+
+    // Ask sysfs whether a block device is rotational (a spinning disk).
+    // Partitions do not carry a queue directory themselves, so fall back to the parent disk.
+    inline bool IsRotational(dev_t device)
+    {
+        std::string base = "/sys/dev/block/" + std::to_string(major(device)) + ":" + std::to_string(minor(device));
+        for (const std::string &candidate : {base + "/queue/rotational", base + "/../queue/rotational"})
+        {
+            std::ifstream file(candidate);
+            int value = 0;
+            if (file >> value)
+                return value == 1;
+        }
+        return false;
+    }
+
+    // Scan every job in parallel.
+    // Jobs are grouped by the device of their root and each device gets its own worker group,
+    // so a slow disk never holds up the projects living on a fast one.
+    // Spinning disks get a single worker to avoid seek thrashing, other devices get one per core.
+    inline void ScanAll(std::vector<Job> &jobs)
+    {
+        std::map<fs::path, dev_t> rootDevices;
+        std::map<dev_t, std::vector<size_t>> groups;
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            auto found = rootDevices.find(jobs[i].root);
+            if (found == rootDevices.end())
+                found = rootDevices.emplace(jobs[i].root, DeviceOf(jobs[i].root)).first;
+            groups[found->second].push_back(i);
+        }
+
+        std::vector<std::thread> groupThreads;
+        for (auto &group : groups)
+        {
+            groupThreads.emplace_back([&jobs, &group]() {
+                const std::vector<size_t> &indices = group.second;
+                size_t workers = IsRotational(group.first) ? 1 : Parallel::HardwareThreads();
+                Parallel::ForEach(indices.size(), workers, [&](size_t i) {
+                    Job &job = jobs[indices[i]];
+                    job.result = ScanProject(job.path);
+                });
+            });
+        }
+        for (auto &t : groupThreads)
+            t.join();
+    }
+} // namespace Scanner
+
+#endif // SCANNER_HPP
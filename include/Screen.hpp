@@ -0,0 +1,180 @@
+#ifndef SCREEN_HPP
+#define SCREEN_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+
+// Full-screen output for live views such as `devcore watch`.
+// A frame is drawn into a back buffer of cells, Present() compares it with the front buffer (what
+// the terminal shows) and writes only the cells that differ, in one write. An unchanged frame
+// costs no output at all, and a change to one value redraws just those characters, however
+// large the view is.
+namespace Screen
+{
+    struct Cell
+    {
+        std::string glyph = " "; // One UTF-8 character, every glyph is taken to be one column wide.
+        Canvas::Color color = Canvas::Color::DEFAULT;
+        bool bold = false;
+
+        bool operator==(const Cell &other) const { return glyph == other.glyph && color == other.color && bold == other.bold; }
+        bool operator!=(const Cell &other) const { return !(*this == other); }
+    };
+
+    class Screen
+    {
+    public:
+        // Switch to the alternate screen with the cursor hidden and the keyboard unbuffered.
+        bool Open()
+        {
+            if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO) || tcgetattr(STDIN_FILENO, &saved) != 0)
+                return false;
+            termios raw = saved;
+            raw.c_lflag &= ~(ICANON | ECHO);
+            raw.c_cc[VMIN] = 0;
+            raw.c_cc[VTIME] = 0;
+            tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+            Write("\033[?1049h\033[?25l");
+            opened = true;
+            Resize();
+            return true;
+        }
+
+        // Restore the terminal as it was before Open().
+        void Close()
+        {
+            if (!opened)
+                return;
+            Write("\033[0m\033[?25h\033[?1049l");
+            tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+            opened = false;
+        }
+
+        // Take the current terminal size. The next Present() redraws everything.
+        void Resize()
+        {
+            winsize size{};
+            if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_row == 0 || size.ws_col == 0)
+                size.ws_row = 24, size.ws_col = 80;
+            rows = size.ws_row;
+            cols = size.ws_col;
+            back.assign(rows * cols, Cell{});
+            front.assign(rows * cols, Cell{""}); // Matches nothing, so every cell is drawn.
+            clearFirst = true;
+        }
+
+        size_t Rows() const { return rows; }
+        size_t Cols() const { return cols; }
+
+        // Start a new frame.
+        void Clear()
+        {
+            back.assign(rows * cols, Cell{});
+        }
+
+        // Write text at a position, cut off at `width` columns and at the right edge.
+        // Returns the number of columns written.
+        size_t Put(size_t row, size_t col, const std::string &text, Canvas::Color color = Canvas::Color::DEFAULT, bool bold = false, size_t width = SIZE_MAX)
+        {
+            if (row >= rows)
+                return 0;
+            size_t written = 0;
+            for (size_t i = 0; i < text.size() && col < cols && written < width; col++, written++)
+            {
+                size_t length = GlyphLength(static_cast<unsigned char>(text[i]));
+                back[row * cols + col] = {text.substr(i, length), color, bold};
+                i += length;
+            }
+            return written;
+        }
+
+        // Fill `width` columns with one glyph.
+        void Fill(size_t row, size_t col, size_t width, const std::string &glyph, Canvas::Color color = Canvas::Color::DEFAULT)
+        {
+            for (size_t c = col; c < cols && c < col + width && row < rows; c++)
+                back[row * cols + c] = {glyph, color, false};
+        }
+
+        // Send the cells that changed since the last frame.
+        void Present()
+        {
+            std::string out;
+            if (clearFirst)
+                out += "\033[0m\033[2J";
+            clearFirst = false;
+
+            size_t cursorRow = SIZE_MAX, cursorCol = SIZE_MAX;
+            const Cell *style = nullptr;
+            for (size_t r = 0; r < rows; r++)
+            {
+                for (size_t c = 0; c < cols; c++)
+                {
+                    const Cell &cell = back[r * cols + c];
+                    Cell &shown = front[r * cols + c];
+                    if (cell == shown)
+                        continue;
+                    if (r != cursorRow || c != cursorCol)
+                        out += "\033[" + std::to_string(r + 1) + ";" + std::to_string(c + 1) + "H";
+                    if (style == nullptr || style->color != cell.color || style->bold != cell.bold)
+                    {
+                        out += "\033[0m";
+                        if (cell.bold)
+                            out += "\033[1m";
+                        if (cell.color != Canvas::Color::DEFAULT)
+                            out += Canvas::ColorToAnsi(cell.color);
+                        style = &cell;
+                    }
+                    out += cell.glyph;
+                    shown = cell;
+                    cursorRow = r;
+                    cursorCol = c + 1;
+                }
+            }
+            if (!out.empty())
+                Write(out + "\033[0m");
+        }
+
+        ~Screen() { Close(); }
+
+    private:
+        static size_t GlyphLength(unsigned char lead)
+        {
+            if (lead >= 0xF0)
+                return 4;
+            if (lead >= 0xE0)
+                return 3;
+            if (lead >= 0xC0)
+                return 2;
+            return 1;
+        }
+
+        static void Write(const std::string &data)
+        {
+            size_t done = 0;
+            while (done < data.size())
+            {
+                ssize_t n = write(STDOUT_FILENO, data.data() + done, data.size() - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    return;
+                done += static_cast<size_t>(n);
+            }
+        }
+
+        termios saved{};
+        bool opened = false;
+        bool clearFirst = true;
+        size_t rows = 0;
+        size_t cols = 0;
+        std::vector<Cell> front;
+        std::vector<Cell> back;
+    };
+} // namespace Screen
+
+#endif // SCREEN_HPP
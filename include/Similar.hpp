@@ -0,0 +1,308 @@
+#ifndef SIMILAR_HPP
+#define SIMILAR_HPP
+
+#include "Dedupe.hpp"
+#include "Hash.hpp"
+#include "Parallel.hpp"
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <limits>
+#include <cmath>
+
+// Near-duplicate projects for `devcore similar`.
+// A project is the set of the content hashes of its files, two projects are as similar as the
+// Jaccard index of their sets. Every project is reduced to a MinHash sketch of HASHES minima, the
+// share of equal minima between two sketches estimates their Jaccard index. Sketches are split
+// into bands and only projects sharing a whole band are compared (LSH), so the work grows with
+// the number of similar pairs rather than with every pair of projects.
+// File hashes come from the dedupe index (hashes.idx) and are added to it, sketches are stored
+// with a fingerprint of the file list so unchanged projects are not read again.
+namespace Similar
+{
+    const size_t HASHES = 128;
+
+    using Signature = std::array<uint64_t, HASHES>;
+
+    struct Sketch
+    {
+        uint64_t fingerprint = 0; // Of the file list (and the template files), see Fingerprint.
+        size_t files = 0;         // Files in the set, template files excluded.
+        Signature minima{};
+    };
+
+    // SplitMix64 finalizer, spreads every input bit over the whole result.
+    inline uint64_t Mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // MinHash of a set: the smallest value of HASHES independent hash functions over its members.
+    inline Signature MinHash(const std::set<uint64_t> &members)
+    {
+        Signature minima;
+        minima.fill(std::numeric_limits<uint64_t>::max());
+        for (uint64_t member : members)
+        {
+            for (size_t i = 0; i < HASHES; i++)
+                minima[i] = std::min(minima[i], Mix(member ^ Mix(i + 1)));
+        }
+        return minima;
+    }
+
+    // Estimated Jaccard index of the sets behind two sketches.
+    inline double Estimate(const Sketch &a, const Sketch &b)
+    {
+        size_t equal = 0;
+        for (size_t i = 0; i < HASHES; i++)
+            equal += a.minima[i] == b.minima[i];
+        return static_cast<double>(equal) / HASHES;
+    }
+
+    // Rows per LSH band for a similarity threshold. Pairs are found with a probability of
+    // 1 - (1 - s^rows)^bands, which rises steeply around (1 / bands)^(1 / rows); the largest band
+    // whose rise stays safely below the threshold is used.
+    inline size_t RowsFor(double threshold)
+    {
+        size_t rows = 1;
+        for (size_t candidate : {2, 4, 8})
+        {
+            double rise = std::pow(1.0 / (HASHES / candidate), 1.0 / candidate);
+            if (rise <= threshold * 0.85)
+                rows = candidate;
+        }
+        return rows;
+    }
+
+    struct Pair
+    {
+        size_t a = 0;
+        size_t b = 0;
+        double similarity = 0;
+    };
+
+    // Pairs of sketches at or above `threshold`. Only sketches that share a band are compared.
+    inline std::vector<Pair> FindPairs(const std::vector<Sketch> &sketches, double threshold, size_t &compared)
+    {
+        size_t rows = RowsFor(threshold);
+        std::set<std::pair<size_t, size_t>> candidates;
+        for (size_t band = 0; band < HASHES / rows; band++)
+        {
+            std::unordered_map<uint64_t, std::vector<size_t>> buckets;
+            for (size_t i = 0; i < sketches.size(); i++)
+            {
+                if (sketches[i].files == 0)
+                    continue;
+                buckets[Hash::Murmur64(sketches[i].minima.data() + band * rows, rows * sizeof(uint64_t), band)].push_back(i);
+            }
+            for (const auto &[key, members] : buckets)
+            {
+                for (size_t x = 0; x < members.size(); x++)
+                {
+                    for (size_t y = x + 1; y < members.size(); y++)
+                        candidates.insert({members[x], members[y]});
+                }
+            }
+        }
+
+        std::vector<Pair> pairs;
+        for (const auto &[a, b] : candidates)
+        {
+            double similarity = Estimate(sketches[a], sketches[b]);
+            if (similarity >= threshold)
+                pairs.push_back({a, b, similarity});
+        }
+        compared = candidates.size();
+        std::sort(pairs.begin(), pairs.end(), [](const Pair &x, const Pair &y) {
+            return x.similarity != y.similarity ? x.similarity > y.similarity : std::make_pair(x.a, x.b) < std::make_pair(y.a, y.b);
+        });
+        return pairs;
+    }
+
+    // Hash of a file list, any added, removed or modified file changes it.
+    inline uint64_t Fingerprint(const std::vector<Dedupe::File> &files, uint64_t seed)
+    {
+        std::vector<Dedupe::Key> keys;
+        for (const auto &file : files)
+            keys.push_back(Dedupe::KeyOf(file));
+        std::sort(keys.begin(), keys.end());
+        uint64_t hash = seed;
+        for (const auto &key : keys)
+        {
+            uint64_t parts[4] = {std::get<0>(key), std::get<1>(key), std::get<2>(key), static_cast<uint64_t>(std::get<3>(key))};
+            hash = Hash::Murmur64(parts, sizeof(parts), hash);
+        }
+        return hash;
+    }
+
+    // Sketch file format, two lines per project: "<fingerprint> <files> <path>" and the minima,
+    // all in hex.
+    inline std::map<std::string, Sketch> LoadSketches(const fs::path &sketchPath)
+    {
+        std::map<std::string, Sketch> sketches;
+        FILE *file = fopen(sketchPath.c_str(), "r");
+        if (!file)
+            return sketches;
+        unsigned long long fingerprint, files;
+        char path[4096];
+        while (std::fscanf(file, "%llx %llx %4095[^\n]", &fingerprint, &files, path) == 3)
+        {
+            Sketch sketch;
+            sketch.fingerprint = fingerprint;
+            sketch.files = files;
+            bool complete = true;
+            for (size_t i = 0; i < HASHES && complete; i++)
+            {
+                unsigned long long value;
+                complete = std::fscanf(file, "%llx", &value) == 1;
+                sketch.minima[i] = value;
+            }
+            if (!complete)
+                break;
+            sketches[path] = sketch;
+        }
+        fclose(file);
+        return sketches;
+    }
+
+    inline void SaveSketches(const fs::path &sketchPath, const std::map<std::string, Sketch> &sketches)
+    {
+        FsUtil::WriteAtomic(sketchPath, [&](FILE *file) {
+            for (const auto &[path, sketch] : sketches)
+            {
+                std::fprintf(file, "%llx %llx %s\n", static_cast<unsigned long long>(sketch.fingerprint), static_cast<unsigned long long>(sketch.files), path.c_str());
+                for (size_t i = 0; i < HASHES; i++)
+                    std::fprintf(file, i + 1 < HASHES ? "%llx " : "%llx\n", static_cast<unsigned long long>(sketch.minima[i]));
+            }
+        });
+    }
+
+    struct Result
+    {
+        std::vector<Sketch> sketches; // One per project, in the order they were given.
+        size_t sketched = 0;          // Projects whose files were (re)hashed.
+        size_t hashed = 0;            // Files read in this run.
+    };
+
+    // Sketch every project. Files identical to a file of the templates are left out, so projects
+    // created from the same template are not similar just because of it.
+    inline Result Run(const std::vector<fs::path> &projects, const fs::path &templates, const fs::path &indexPath, const fs::path &sketchPath)
+    {
+        Result result;
+        result.sketches.resize(projects.size());
+        size_t workers = Parallel::HardwareThreads();
+
+        // Slot 0 holds the template files, slot i + 1 the files of project i.
+        std::vector<std::vector<Dedupe::File>> files(projects.size() + 1);
+        Parallel::ForEach(files.size(), workers, [&](size_t i) {
+            if (i > 0)
+                Dedupe::Collect(projects[i - 1], files[i]);
+            else if (fs::is_directory(templates))
+                Dedupe::Collect(templates, files[0]);
+        });
+
+        uint64_t templateFingerprint = Fingerprint(files[0], 0);
+        std::map<std::string, Sketch> stored = LoadSketches(sketchPath);
+        std::vector<size_t> stale;
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            uint64_t fingerprint = Fingerprint(files[i + 1], templateFingerprint);
+            auto found = stored.find(projects[i].string());
+            if (found != stored.end() && found->second.fingerprint == fingerprint)
+                result.sketches[i] = found->second;
+            else
+                stale.push_back(i);
+            result.sketches[i].fingerprint = fingerprint;
+        }
+
+        if (!stale.empty())
+        {
+            // Content hashes of the template files and of every file of a stale project.
+            std::map<Dedupe::Key, Dedupe::Hashes> index = Dedupe::LoadIndex(indexPath);
+            std::vector<Dedupe::File *> pending;
+            auto lookup = [&](Dedupe::File &file) {
+                auto found = index.find(Dedupe::KeyOf(file));
+                if (found != index.end() && found->second.hasFull)
+                {
+                    file.partial = found->second.partial;
+                    file.full = found->second.full;
+                    file.hasPartial = file.hasFull = true;
+                }
+                else
+                {
+                    pending.push_back(&file);
+                }
+            };
+            for (auto &file : files[0])
+                lookup(file);
+            for (size_t i : stale)
+            {
+                for (auto &file : files[i + 1])
+                    lookup(file);
+            }
+            Parallel::ForEach(pending.size(), workers, [&](size_t i) {
+                Dedupe::File &file = *pending[i];
+                file.hasPartial = Dedupe::HashFile(file.path, Dedupe::PARTIAL_BYTES, file.partial);
+                if (file.hasPartial && file.size <= Dedupe::PARTIAL_BYTES)
+                {
+                    file.full = file.partial;
+                    file.hasFull = true;
+                }
+                else if (file.hasPartial)
+                {
+                    file.hasFull = Dedupe::HashFile(file.path, 0, file.full);
+                }
+            });
+            result.hashed = pending.size();
+            result.sketched = stale.size();
+
+            std::set<uint64_t> templateHashes;
+            for (const auto &file : files[0])
+            {
+                if (file.hasFull)
+                    templateHashes.insert(file.full);
+            }
+            Parallel::ForEach(stale.size(), workers, [&](size_t s) {
+                size_t i = stale[s];
+                std::set<uint64_t> members;
+                for (const auto &file : files[i + 1])
+                {
+                    if (file.hasFull && templateHashes.count(file.full) == 0)
+                        members.insert(file.full);
+                }
+                result.sketches[i].files = members.size();
+                result.sketches[i].minima = MinHash(members);
+            });
+
+            // New hashes are added to the dedupe index, its own entries stay as they are.
+            if (!pending.empty())
+            {
+                for (const auto *file : pending)
+                {
+                    if (file->hasFull)
+                        index[Dedupe::KeyOf(*file)] = {file->partial, file->full, true};
+                }
+                Dedupe::SaveIndex(indexPath, index);
+            }
+        }
+
+        std::map<std::string, Sketch> updated;
+        for (size_t i = 0; i < projects.size(); i++)
+            updated[projects[i].string()] = result.sketches[i];
+        if (!stale.empty() || updated.size() != stored.size())
+            SaveSketches(sketchPath, updated);
+        return result;
+    }
+} // namespace Similar
+
+#endif // SIMILAR_HPP
@@ -0,0 +1,287 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include "Scanner.hpp"
+#include "Artifacts.hpp"
+#include "Parallel.hpp"
+#include "FsUtil.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <tuple>
+#include <atomic>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Line and file counts for `devcore stats`.
+// Files are mapped and their newlines counted 16 bytes at a time with SSE2. Counts are cached by
+// (device, inode, mtime, size), so a rerun only reads files that changed since the last one.
+namespace Stats
+{
+    struct Count
+    {
+        size_t files = 0;
+        size_t lines = 0;
+    };
+
+    // Type of a file by its extension or, for build files, its name.
+    inline std::string TypeOf(const char *name)
+    {
+        static const std::map<std::string, std::string> byName{
+            {"Makefile", "Makefile"}, {"makefile", "Makefile"}, {"GNUmakefile", "Makefile"},
+            {"CMakeLists.txt", "CMake"}, {"Dockerfile", "Dockerfile"}, {"LICENSE", "Text"}, {"README", "Text"}};
+        static const std::map<std::string, std::string> byExtension{
+            {".c", "C"}, {".h", "C/C++ Header"}, {".hh", "C/C++ Header"}, {".hpp", "C/C++ Header"}, {".hxx", "C/C++ Header"},
+            {".cc", "C++"}, {".cpp", "C++"}, {".cxx", "C++"}, {".inl", "C++"}, {".ipp", "C++"}, {".tpp", "C++"},
+            {".cs", "C#"}, {".java", "Java"}, {".kt", "Kotlin"}, {".go", "Go"}, {".rs", "Rust"}, {".swift", "Swift"},
+            {".py", "Python"}, {".rb", "Ruby"}, {".php", "PHP"}, {".lua", "Lua"}, {".pl", "Perl"},
+            {".js", "JavaScript"}, {".mjs", "JavaScript"}, {".jsx", "JavaScript"}, {".ts", "TypeScript"}, {".tsx", "TypeScript"},
+            {".html", "HTML"}, {".htm", "HTML"}, {".css", "CSS"}, {".scss", "CSS"}, {".vue", "Vue"},
+            {".sh", "Shell"}, {".bash", "Shell"}, {".zsh", "Shell"}, {".ps1", "PowerShell"}, {".bat", "Batch"},
+            {".sql", "SQL"}, {".cmake", "CMake"}, {".mk", "Makefile"},
+            {".json", "JSON"}, {".yml", "YAML"}, {".yaml", "YAML"}, {".toml", "TOML"}, {".xml", "XML"}, {".ini", "INI"},
+            {".md", "Markdown"}, {".rst", "reStructuredText"}, {".txt", "Text"}};
+
+        auto named = byName.find(name);
+        if (named != byName.end())
+            return named->second;
+        const char *dot = std::strrchr(name, '.');
+        if (dot == nullptr || dot == name)
+            return "Other";
+        auto typed = byExtension.find(dot);
+        return typed != byExtension.end() ? typed->second : "Other";
+    }
+
+    // Number of '\n' bytes in a buffer.
+    inline size_t CountNewlines(const char *data, size_t size)
+    {
+        size_t count = 0;
+        size_t i = 0;
+#if defined(__SSE2__)
+        // A matching byte compares as -1, subtracting it adds one to its lane. The lanes are summed
+        // with SAD before any of them can overflow at 255.
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i zero = _mm_setzero_si128();
+        while (size - i >= 16)
+        {
+            __m128i lanes = zero;
+            size_t blocks = std::min<size_t>((size - i) / 16, 255);
+            for (size_t b = 0; b < blocks; b++, i += 16)
+            {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(chunk, newline));
+            }
+            __m128i sums = _mm_sad_epu8(lanes, zero);
+            count += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+        }
+#endif
+        for (; i < size; i++)
+            count += data[i] == '\n';
+        return count;
+    }
+
+    // Lines of a text buffer, a last line without a newline counts too.
+    inline size_t CountLines(const char *data, size_t size)
+    {
+        if (size == 0)
+            return 0;
+        return CountNewlines(data, size) + (data[size - 1] != '\n');
+    }
+
+    struct File
+    {
+        size_t project = 0;
+        std::string path;
+        std::string type;
+        dev_t device = 0;
+        ino_t inode = 0;
+        int64_t mtime = 0; // Nanoseconds.
+        uint64_t size = 0;
+        size_t lines = 0;
+        bool binary = false;
+    };
+
+    // Every file of a project that is not a build artifact.
+    inline std::vector<File> ListFiles(size_t project, const fs::path &projectPath, const std::string &lang)
+    {
+        std::vector<File> files;
+        Artifacts::WalkSources(projectPath, lang, [&](const std::string &relPath, const char *name, const struct stat &st) {
+            if (!S_ISREG(st.st_mode))
+                return;
+            File file;
+            file.project = project;
+            file.path = (projectPath / relPath).string();
+            file.type = TypeOf(name);
+            file.device = st.st_dev;
+            file.inode = st.st_ino;
+            file.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+            file.size = static_cast<uint64_t>(st.st_size);
+            files.push_back(std::move(file));
+        });
+        return files;
+    }
+
+    // Map a file and count its lines. A NUL byte in the first 8 KiB marks it as binary, binary
+    // files count as files but not as lines.
+    inline void CountFile(File &file)
+    {
+        file.lines = 0;
+        file.binary = false;
+        if (file.size == 0)
+            return;
+        int fd = open(file.path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        // The size is from the walk. A file that shrank since is being saved, counting it would
+        // touch the mapping past its end (SIGBUS), so it is left out.
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) != file.size)
+        {
+            close(fd);
+            return;
+        }
+        void *data = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return;
+        madvise(data, file.size, MADV_SEQUENTIAL);
+        const char *text = static_cast<const char *>(data);
+        file.binary = std::memchr(text, '\0', std::min<uint64_t>(file.size, 8192)) != nullptr;
+        if (!file.binary)
+            file.lines = CountLines(text, file.size);
+        munmap(data, file.size);
+    }
+
+    using Key = std::tuple<dev_t, ino_t, int64_t, uint64_t>;
+
+    struct CacheEntry
+    {
+        size_t lines = 0;
+        bool binary = false;
+    };
+
+    // Cache format, one file per line: "<device> <inode> <mtime> <size> <lines> <binary>" in hex.
+    inline std::map<Key, CacheEntry> LoadCache(const fs::path &cachePath)
+    {
+        std::map<Key, CacheEntry> cache;
+        FILE *file = fopen(cachePath.c_str(), "r");
+        if (!file)
+            return cache;
+        unsigned long long device, inode, size, lines;
+        long long mtime;
+        int binary;
+        while (std::fscanf(file, "%llx %llx %llx %llx %llx %x", &device, &inode, &mtime, &size, &lines, &binary) == 6)
+            cache[{static_cast<dev_t>(device), static_cast<ino_t>(inode), mtime, size}] = {static_cast<size_t>(lines), binary != 0};
+        fclose(file);
+        return cache;
+    }
+
+    inline void SaveCache(const fs::path &cachePath, const std::map<Key, CacheEntry> &cache)
+    {
+        FsUtil::WriteAtomic(cachePath, [&](FILE *file) {
+            for (const auto &[key, entry] : cache)
+            {
+                std::fprintf(file, "%llx %llx %llx %llx %llx %x\n",
+                             static_cast<unsigned long long>(std::get<0>(key)), static_cast<unsigned long long>(std::get<1>(key)),
+                             static_cast<long long>(std::get<2>(key)), static_cast<unsigned long long>(std::get<3>(key)),
+                             static_cast<unsigned long long>(entry.lines), entry.binary ? 1 : 0);
+            }
+        });
+    }
+
+    struct ProjectInput
+    {
+        fs::path path;
+        std::string lang;
+    };
+
+    struct Result
+    {
+        std::vector<std::map<std::string, Count>> types; // Per project, by file type.
+        size_t counted = 0;                               // Files read in this run.
+        size_t cached = 0;                                // Files answered by the cache.
+    };
+
+    // Count the files of every project. Projects are listed in parallel, then all their files are
+    // counted in parallel. With `prune` the cache keeps only the files seen in this run, otherwise
+    // entries of projects that were not part of it are kept.
+    inline Result Scan(const std::vector<ProjectInput> &projects, const fs::path &cachePath, bool prune)
+    {
+        Result result;
+        result.types.resize(projects.size());
+
+        std::vector<std::vector<File>> perProject(projects.size());
+        Parallel::ForEach(projects.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            perProject[i] = ListFiles(i, projects[i].path, projects[i].lang);
+        });
+        std::vector<File> files;
+        for (auto &list : perProject)
+        {
+            for (auto &file : list)
+                files.push_back(std::move(file));
+        }
+
+        std::map<Key, CacheEntry> cache = LoadCache(cachePath);
+        std::atomic<size_t> counted{0};
+        Parallel::ForEach(files.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            File &file = files[i];
+            auto hit = cache.find({file.device, file.inode, file.mtime, file.size});
+            if (hit != cache.end())
+            {
+                file.lines = hit->second.lines;
+                file.binary = hit->second.binary;
+                return;
+            }
+            CountFile(file);
+            counted++;
+        });
+        result.counted = counted;
+        result.cached = files.size() - result.counted;
+
+        std::map<Key, CacheEntry> updated;
+        std::set<std::pair<dev_t, ino_t>> seen;
+        for (const auto &file : files)
+        {
+            Count &count = result.types[file.project][file.binary ? "Binary" : file.type];
+            count.files++;
+            count.lines += file.lines;
+            updated[{file.device, file.inode, file.mtime, file.size}] = {file.lines, file.binary};
+            seen.insert({file.device, file.inode});
+        }
+        // Older versions of the files seen in this run are dropped either way.
+        for (const auto &[key, entry] : cache)
+        {
+            if (!prune && seen.count({std::get<0>(key), std::get<1>(key)}) == 0)
+                updated.emplace(key, entry);
+        }
+        if (result.counted > 0 || updated.size() != cache.size())
+            SaveCache(cachePath, updated);
+        return result;
+    }
+
+    // "12,345".
+    inline std::string Grouped(size_t value)
+    {
+        std::string digits = std::to_string(value);
+        std::string grouped;
+        for (size_t i = 0; i < digits.size(); i++)
+        {
+            if (i > 0 && (digits.size() - i) % 3 == 0)
+                grouped += ',';
+            grouped += digits[i];
+        }
+        return grouped;
+    }
+} // namespace Stats
+
+#endif // STATS_HPP
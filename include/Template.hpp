@@ -0,0 +1,568 @@
+#ifndef TEMPLATE_HPP
+#define TEMPLATE_HPP
+
+#include "Hash.hpp"
+#include "Parallel.hpp"
+#include "FsUtil.hpp"
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <filesystem>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <nlohmann/json.hpp>
+namespace fs = std::filesystem;
+
+// Template instantiation with `{{variable}}` placeholders in file contents and file names.
+// Text files are rewritten in a single streaming pass while they are copied, binary files
+// (a NUL byte in the first chunk) and files without placeholders are cloned untouched.
+// Unknown placeholders are left as they are.
+namespace Template
+{
+    const size_t CHUNK_BYTES = 1 << 16;
+
+    // The placeholders of one instantiation, compiled once and shared by every file.
+    // Every placeholder starts with "{{", so the matcher only stops at the '{' bytes memchr finds
+    // and then compares the few candidate tokens, sorted longest first.
+    class Matcher
+    {
+    public:
+        explicit Matcher(const std::map<std::string, std::string> &variables)
+        {
+            for (const auto &variable : variables)
+                tokens.push_back({"{{" + variable.first + "}}", variable.second});
+            std::sort(tokens.begin(), tokens.end(), [](const Token &a, const Token &b) { return a.text.size() > b.text.size(); });
+            for (const auto &token : tokens)
+                longest = std::max(longest, token.text.size());
+        }
+
+        // Substitute every placeholder in data and append the result to out.
+        // With `final` unset, a possible placeholder cut off at the end of data is not consumed;
+        // the number of bytes consumed is returned so the caller can carry the rest over.
+        size_t Substitute(std::string_view data, std::string &out, bool final) const
+        {
+            size_t pos = 0;
+            while (pos < data.size())
+            {
+                const void *found = std::memchr(data.data() + pos, '{', data.size() - pos);
+                size_t brace = found ? static_cast<size_t>(static_cast<const char *>(found) - data.data()) : data.size();
+                out.append(data.data() + pos, brace - pos);
+                pos = brace;
+                if (pos == data.size())
+                    break;
+
+                std::string_view rest = data.substr(pos);
+                if (!final && rest.size() < longest && IsPrefixOfToken(rest))
+                    return pos;
+                const Token *token = Match(rest);
+                if (token)
+                {
+                    out += token->value;
+                    pos += token->text.size();
+                }
+                else
+                {
+                    out.push_back('{');
+                    pos++;
+                }
+            }
+            return pos;
+        }
+
+        std::string Substitute(const std::string &text) const
+        {
+            std::string out;
+            Substitute(text, out, true);
+            return out;
+        }
+
+    private:
+        struct Token
+        {
+            std::string text; // "{{name}}"
+            std::string value;
+        };
+
+        const Token *Match(std::string_view rest) const
+        {
+            if (rest.size() < 2 || rest[1] != '{')
+                return nullptr;
+            for (const auto &token : tokens)
+            {
+                if (rest.substr(0, token.text.size()) == token.text)
+                    return &token;
+            }
+            return nullptr;
+        }
+
+        bool IsPrefixOfToken(std::string_view rest) const
+        {
+            for (const auto &token : tokens)
+            {
+                if (std::string_view(token.text).substr(0, rest.size()) == rest)
+                    return true;
+            }
+            return false;
+        }
+
+        std::vector<Token> tokens;
+        size_t longest = 0;
+    };
+
+    inline bool WriteAll(int fd, const char *data, size_t length)
+    {
+        while (length > 0)
+        {
+            ssize_t written = write(fd, data, length);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written < 0)
+                return false;
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // Copy the rest of src into dst: a reflink where the filesystem supports it,
+    // otherwise copy_file_range so the data never passes through user space.
+    // With a size hint the destination is preallocated before a real copy.
+    inline bool CloneRest(int src, int dst, off_t offset, uint64_t sizeHint = 0)
+    {
+        if (offset == 0 && ioctl(dst, FICLONE, src) == 0)
+            return true;
+        if (sizeHint > static_cast<uint64_t>(offset))
+            fallocate(dst, FALLOC_FL_KEEP_SIZE, offset, static_cast<off_t>(sizeHint) - offset);
+        lseek(src, offset, SEEK_SET);
+        lseek(dst, offset, SEEK_SET);
+        while (true)
+        {
+            ssize_t copied = copy_file_range(src, nullptr, dst, nullptr, CHUNK_BYTES * 16, 0);
+            if (copied == 0)
+                return true;
+            if (copied < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+        }
+        // copy_file_range is not available (old kernel, cross-device), fall back to read/write.
+        std::vector<char> buf(CHUNK_BYTES);
+        ssize_t n;
+        while ((n = read(src, buf.data(), buf.size())) > 0)
+        {
+            if (!WriteAll(dst, buf.data(), static_cast<size_t>(n)))
+                return false;
+        }
+        return n == 0;
+    }
+
+    // How a template file is copied.
+    enum class Kind
+    {
+        Text,   // Contains "{{", streamed through the matcher.
+        Plain,  // Text without any placeholder, cloned like a binary file.
+        Binary  // A NUL byte in the first chunk, cloned untouched.
+    };
+
+    // Copy one file, substituting placeholders unless the file is binary.
+    // Reports the bytes written and the content hash of the source (chained Murmur64 over
+    // 64 KiB chunks), which is only computed for files that are streamed.
+    inline bool CopyFile(const fs::path &source, const fs::path &destination, mode_t mode, const Matcher &matcher,
+                         uint64_t &written, uint64_t *hash = nullptr, Kind kind = Kind::Text, uint64_t sizeHint = 0)
+    {
+        int src = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+        if (src < 0)
+            return false;
+        int dst = open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode & 07777);
+        if (dst < 0)
+        {
+            close(src);
+            return false;
+        }
+
+        if (kind != Kind::Text)
+        {
+            bool ok = CloneRest(src, dst, 0, sizeHint);
+            struct stat st;
+            written = ok && fstat(dst, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+            close(src);
+            return close(dst) == 0 && ok;
+        }
+
+        std::vector<char> buf(CHUNK_BYTES);
+        std::string pending; // Input carried over because it may start a placeholder.
+        std::string out;
+        bool ok = true;
+        bool first = true;
+        uint64_t contentHash = 0;
+        written = 0;
+        ssize_t n;
+        while (ok && (n = FsUtil::ReadFull(src, buf.data(), buf.size())) > 0)
+        {
+            if (first && std::memchr(buf.data(), '\0', static_cast<size_t>(n)) != nullptr)
+            {
+                ok = CloneRest(src, dst, 0);
+                struct stat st;
+                written = ok && fstat(dst, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+                close(src);
+                close(dst);
+                if (hash)
+                    *hash = 0;
+                return ok;
+            }
+            first = false;
+            contentHash = Hash::Murmur64(buf.data(), static_cast<size_t>(n), contentHash);
+
+            pending.append(buf.data(), static_cast<size_t>(n));
+            out.clear();
+            size_t consumed = matcher.Substitute(pending, out, false);
+            pending.erase(0, consumed);
+            ok = WriteAll(dst, out.data(), out.size());
+            written += out.size();
+        }
+        if (ok && n < 0)
+            ok = false;
+        if (ok && !pending.empty())
+        {
+            out.clear();
+            matcher.Substitute(pending, out, true);
+            ok = WriteAll(dst, out.data(), out.size());
+            written += out.size();
+        }
+        if (hash)
+            *hash = contentHash;
+        close(src);
+        ok = close(dst) == 0 && ok;
+        return ok;
+    }
+
+    // The manifest every template carries: its directories, files and symlinks with the sizes,
+    // modes and content hashes, so instantiation needs no directory walk. It is stored as
+    // MANIFEST_NAME inside the template and is rebuilt whenever a directory of the template
+    // changed (an entry was added, removed or renamed) since it was written.
+    const std::string MANIFEST_NAME = ".devcore-template.json";
+    const int MANIFEST_VERSION = 1;
+
+    struct FileEntry
+    {
+        std::string path; // Relative to the template.
+        uint64_t size = 0;
+        mode_t mode = 0644;
+        int64_t mtime = 0; // Nanoseconds.
+        uint64_t hash = 0;
+        Kind kind = Kind::Text;
+    };
+
+    struct DirEntry
+    {
+        std::string path; // Relative to the template, empty for the template itself.
+        mode_t mode = 0755;
+        int64_t mtime = 0;
+    };
+
+    struct LinkEntry
+    {
+        std::string path;
+        std::string target;
+    };
+
+    struct Manifest
+    {
+        std::vector<DirEntry> dirs; // Parents always come before their children.
+        std::vector<FileEntry> files;
+        std::vector<LinkEntry> links;
+        uint64_t totalSize = 0;
+    };
+
+    inline int64_t MtimeOf(const struct stat &st)
+    {
+        return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    }
+
+    inline std::string Hex(uint64_t value)
+    {
+        char buffer[17];
+        std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+        return buffer;
+    }
+
+    // Read a file once to classify it and hash it.
+    inline bool Inspect(const fs::path &path, FileEntry &entry)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        std::vector<char> buf(CHUNK_BYTES);
+        entry.hash = 0;
+        entry.kind = Kind::Plain;
+        bool first = true;
+        char last = '\0';
+        ssize_t n;
+        while ((n = FsUtil::ReadFull(fd, buf.data(), buf.size())) > 0)
+        {
+            size_t length = static_cast<size_t>(n);
+            if (first && std::memchr(buf.data(), '\0', length) != nullptr)
+                entry.kind = Kind::Binary;
+            if (entry.kind == Kind::Plain && ((last == '{' && buf[0] == '{') || std::string_view(buf.data(), length).find("{{") != std::string_view::npos))
+                entry.kind = Kind::Text;
+            last = buf[length - 1];
+            first = false;
+            entry.hash = Hash::Murmur64(buf.data(), length, entry.hash);
+        }
+        close(fd);
+        return n == 0;
+    }
+
+    // Walk a template once and describe it. Files are hashed in parallel.
+    inline Manifest BuildManifest(const fs::path &source)
+    {
+        Manifest manifest;
+        std::vector<std::string> stack{""};
+        while (!stack.empty())
+        {
+            std::string rel = std::move(stack.back());
+            stack.pop_back();
+            fs::path dir = rel.empty() ? source : source / rel;
+            DIR *handle = opendir(dir.c_str());
+            if (!handle)
+                continue;
+            struct stat dirStat;
+            fstat(dirfd(handle), &dirStat);
+            manifest.dirs.push_back({rel, dirStat.st_mode & 07777, MtimeOf(dirStat)});
+            while (struct dirent *entry = readdir(handle))
+            {
+                const char *name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    continue;
+                // The manifest and the temporary files it is written through.
+                if (rel.empty() && std::string_view(name).compare(0, MANIFEST_NAME.size(), MANIFEST_NAME) == 0)
+                    continue;
+                std::string childRel = rel.empty() ? std::string(name) : rel + "/" + name;
+                struct stat st;
+                if (fstatat(dirfd(handle), name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                    continue;
+                if (S_ISDIR(st.st_mode))
+                {
+                    stack.push_back(childRel);
+                }
+                else if (S_ISLNK(st.st_mode))
+                {
+                    std::error_code ec;
+                    manifest.links.push_back({childRel, fs::read_symlink(dir / name, ec).string()});
+                }
+                else if (S_ISREG(st.st_mode))
+                {
+                    FileEntry file;
+                    file.path = childRel;
+                    file.size = static_cast<uint64_t>(st.st_size);
+                    file.mode = st.st_mode & 07777;
+                    file.mtime = MtimeOf(st);
+                    manifest.files.push_back(file);
+                    manifest.totalSize += file.size;
+                }
+            }
+            closedir(handle);
+        }
+
+        Parallel::ForEach(manifest.files.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            Inspect(source / manifest.files[i].path, manifest.files[i]);
+        });
+        return manifest;
+    }
+
+    // Write the manifest into the template through a temporary file, so a concurrent
+    // create-project never reads it half written. Renaming it in changes the template's own mtime,
+    // which the content cannot hold any more, so that mtime is stamped onto the manifest file and
+    // LoadManifest takes the template's mtime from there.
+    inline bool WriteManifest(const fs::path &source, Manifest &manifest)
+    {
+        nlohmann::json data = {{"version", MANIFEST_VERSION}, {"total_size", manifest.totalSize}};
+        data["dirs"] = nlohmann::json::array();
+        for (const auto &dir : manifest.dirs)
+            data["dirs"].push_back({{"path", dir.path}, {"mode", dir.mode}, {"mtime", dir.mtime}});
+        data["files"] = nlohmann::json::array();
+        for (const auto &file : manifest.files)
+        {
+            const char *kind = file.kind == Kind::Text ? "text" : file.kind == Kind::Plain ? "plain" : "binary";
+            data["files"].push_back({{"path", file.path}, {"size", file.size}, {"mode", file.mode}, {"mtime", file.mtime}, {"hash", Hex(file.hash)}, {"kind", kind}});
+        }
+        data["links"] = nlohmann::json::array();
+        for (const auto &link : manifest.links)
+            data["links"].push_back({{"path", link.path}, {"target", link.target}});
+
+        std::string text = data.dump(1);
+        fs::path manifestPath = source / MANIFEST_NAME;
+        if (!FsUtil::WriteAtomic(manifestPath, [&](FILE *file) { std::fwrite(text.data(), 1, text.size(), file); }))
+            return false;
+        struct stat rootStat;
+        if (stat(source.c_str(), &rootStat) != 0)
+            return false;
+        struct timespec times[2] = {{0, UTIME_OMIT}, rootStat.st_mtim};
+        if (utimensat(AT_FDCWD, manifestPath.c_str(), times, 0) != 0)
+            return false;
+        if (!manifest.dirs.empty() && manifest.dirs.front().path.empty())
+            manifest.dirs.front().mtime = MtimeOf(rootStat);
+        return true;
+    }
+
+    inline bool LoadManifest(const fs::path &source, Manifest &manifest)
+    {
+        std::ifstream file(source / MANIFEST_NAME);
+        nlohmann::json data = nlohmann::json::parse(file, nullptr, false);
+        if (data.is_discarded() || !data.is_object() || data.value("version", 0) != MANIFEST_VERSION)
+            return false;
+        try
+        {
+            manifest = Manifest();
+            manifest.totalSize = data.value("total_size", static_cast<uint64_t>(0));
+            for (const auto &dir : data.at("dirs"))
+                manifest.dirs.push_back({dir.at("path"), dir.at("mode"), dir.at("mtime")});
+            for (const auto &entry : data.at("files"))
+            {
+                FileEntry file;
+                file.path = entry.at("path");
+                file.size = entry.at("size");
+                file.mode = entry.at("mode");
+                file.mtime = entry.at("mtime");
+                file.hash = std::strtoull(entry.at("hash").get<std::string>().c_str(), nullptr, 16);
+                std::string kind = entry.at("kind");
+                file.kind = kind == "text" ? Kind::Text : kind == "plain" ? Kind::Plain : Kind::Binary;
+                manifest.files.push_back(file);
+            }
+            for (const auto &link : data.at("links"))
+                manifest.links.push_back({link.at("path"), link.at("target")});
+        }
+        catch (const nlohmann::json::exception &)
+        {
+            return false;
+        }
+        // The template's own mtime is the one stamped onto the manifest file (see WriteManifest).
+        struct stat manifestStat;
+        if (manifest.dirs.empty() || !manifest.dirs.front().path.empty() || stat((source / MANIFEST_NAME).c_str(), &manifestStat) != 0)
+            return false;
+        manifest.dirs.front().mtime = MtimeOf(manifestStat);
+        return true;
+    }
+
+    // A manifest is current while none of the template's directories changed, which only costs
+    // one stat per directory. Edited files are caught per file during instantiation.
+    inline bool IsCurrent(const fs::path &source, const Manifest &manifest)
+    {
+        for (const auto &dir : manifest.dirs)
+        {
+            struct stat st;
+            if (stat((dir.path.empty() ? source : source / dir.path).c_str(), &st) != 0 || MtimeOf(st) != dir.mtime)
+                return false;
+        }
+        return true;
+    }
+
+    // The template's manifest, rebuilt and rewritten when it is missing or outdated.
+    inline Manifest ManifestFor(const fs::path &source)
+    {
+        Manifest manifest;
+        if (LoadManifest(source, manifest) && IsCurrent(source, manifest))
+            return manifest;
+        manifest = BuildManifest(source);
+        WriteManifest(source, manifest);
+        return manifest;
+    }
+
+    // Instantiate a template directory into destination (which may already exist).
+    // Directory and file names are substituted as well, symlinks are recreated as they are.
+    // The layout comes from the manifest: directories are created up front and files are copied
+    // on `workers` threads. A file whose size or mtime no longer matches the manifest is copied
+    // as found and the manifest is refreshed afterwards; a file that still matches but whose
+    // content hash differs is corrupted and fails the instantiation. Files that are cloned are
+    // hashed before they are copied, text files while they stream, and a corrupted text file is
+    // removed from the destination again, so no corrupted content is left in the project.
+    inline bool Instantiate(const fs::path &source, const fs::path &destination, const std::map<std::string, std::string> &variables,
+                            std::string &error, size_t workers = Parallel::HardwareThreads(), uint64_t *written = nullptr)
+    {
+        Matcher matcher(variables);
+        Manifest manifest = ManifestFor(source);
+        std::error_code ec;
+        fs::create_directories(destination, ec);
+
+        auto target = [&](const std::string &rel) {
+            return rel.empty() ? destination : destination / matcher.Substitute(rel);
+        };
+        for (const auto &dir : manifest.dirs)
+        {
+            fs::path path = target(dir.path);
+            if (mkdir(path.c_str(), dir.mode) != 0 && errno != EEXIST)
+            {
+                error = "Cannot create '" + path.string() + "': " + std::strerror(errno);
+                return false;
+            }
+        }
+        for (const auto &link : manifest.links)
+        {
+            fs::create_symlink(link.target, target(link.path), ec);
+            if (ec)
+            {
+                error = "Cannot create '" + target(link.path).string() + "': " + ec.message();
+                return false;
+            }
+        }
+
+        std::vector<std::string> errors(manifest.files.size());
+        std::atomic<uint64_t> total{0};
+        std::atomic<bool> stale{false};
+        Parallel::ForEach(manifest.files.size(), workers, [&](size_t i) {
+            const FileEntry &file = manifest.files[i];
+            fs::path from = source / file.path;
+            fs::path to = target(file.path);
+            struct stat st;
+            bool matches = stat(from.c_str(), &st) == 0 && static_cast<uint64_t>(st.st_size) == file.size && MtimeOf(st) == file.mtime;
+            if (!matches)
+                stale = true;
+
+            std::string corrupted = "Template file '" + file.path + "' is corrupted (its content does not match the template manifest). Add the template again, or delete its " + MANIFEST_NAME + " to accept the change.";
+            uint64_t bytes = 0;
+            uint64_t hash = 0;
+            Kind kind = matches ? file.kind : Kind::Text;
+            FileEntry inspected;
+            if (matches && kind != Kind::Text && Inspect(from, inspected) && inspected.hash != file.hash)
+                errors[i] = corrupted;
+            else if (!CopyFile(from, to, file.mode, matcher, bytes, &hash, kind, file.size))
+                errors[i] = "Cannot copy '" + file.path + "': " + std::strerror(errno);
+            else if (matches && kind == Kind::Text && hash != file.hash)
+            {
+                unlink(to.c_str());
+                bytes = 0;
+                errors[i] = corrupted;
+            }
+            total += bytes;
+        });
+
+        if (stale)
+            WriteManifest(source, manifest = BuildManifest(source));
+        if (written)
+            *written = total;
+        for (const auto &message : errors)
+        {
+            if (!message.empty())
+            {
+                error = message;
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace Template
+
+#endif // TEMPLATE_HPP
@@ -0,0 +1,280 @@
+#ifndef TRASH_HPP
+#define TRASH_HPP
+
+#include "FsUtil.hpp"
+#include "Parallel.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <ctime>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <nlohmann/json.hpp>
+
+// Deleted projects are renamed into a trash directory inside their projects root, which is a
+// single atomic rename on the same filesystem. A detached worker unlinks them in parallel once
+// their grace period is over, until then `devcore trash undo` can move them back.
+//
+// Layout: <root>/.devcore-trash/<id>/meta.json    project entry, original path and purge time
+//                                    /project      the project tree itself
+// A worker claims an entry by renaming <id> to <id>.purging, so an undo and a purge never race.
+namespace Trash
+{
+    const std::string DIR_NAME = ".devcore-trash";
+    const std::string PURGING_SUFFIX = ".purging";
+
+    // Seconds a deleted project stays undoable when `trash_grace` is not configured.
+    const long DEFAULT_GRACE = 600;
+
+    struct Entry
+    {
+        std::string id;
+        fs::path path;        // The entry directory.
+        nlohmann::json meta;  // Empty for entries that are being purged.
+        bool purging = false;
+    };
+
+    inline fs::path DirFor(const fs::path &root)
+    {
+        return root / DIR_NAME;
+    }
+
+    inline time_t PurgeAt(const Entry &entry)
+    {
+        return entry.meta.value("purge_at", static_cast<time_t>(0));
+    }
+
+    // Move a project into the trash of its root. meta must hold the DevMap "project" entry.
+    // Returns the entry id, or an empty string with `error` set if nothing was moved.
+    inline std::string MoveToTrash(const fs::path &root, const fs::path &projPath, nlohmann::json meta, long grace, std::string &error)
+    {
+        fs::path trashDir = DirFor(root);
+        std::error_code ec;
+        fs::create_directories(trashDir, ec);
+        if (ec)
+        {
+            error = "Cannot create trash directory '" + trashDir.string() + "': " + ec.message();
+            return "";
+        }
+
+        time_t now = std::time(nullptr);
+        std::string base = std::to_string(now) + "-" + projPath.filename().string();
+        std::string id = base;
+        for (int n = 1; mkdir((trashDir / id).c_str(), 0755) != 0; n++)
+        {
+            if (errno != EEXIST)
+            {
+                error = "Cannot create trash entry: " + std::string(std::strerror(errno));
+                return "";
+            }
+            id = base + "-" + std::to_string(n);
+        }
+
+        fs::path entryPath = trashDir / id;
+        meta["id"] = id;
+        meta["path"] = projPath.string();
+        meta["trashed_at"] = now;
+        meta["purge_at"] = now + grace;
+        std::ofstream file(entryPath / "meta.json");
+        file << meta.dump(4);
+        file.close();
+        if (!file)
+        {
+            error = "Cannot write '" + (entryPath / "meta.json").string() + "'.";
+            fs::remove_all(entryPath, ec);
+            return "";
+        }
+
+        if (rename(projPath.c_str(), (entryPath / "project").c_str()) != 0)
+        {
+            error = errno == EXDEV ? "The project is on another filesystem than its projects root." : std::string(std::strerror(errno));
+            fs::remove_all(entryPath, ec);
+            return "";
+        }
+        return id;
+    }
+
+    // Every trash entry under the given roots, oldest first.
+    inline std::vector<Entry> List(const std::vector<fs::path> &roots)
+    {
+        std::vector<Entry> entries;
+        for (const auto &root : roots)
+        {
+            std::error_code ec;
+            for (const auto &dirEntry : fs::directory_iterator(DirFor(root), ec))
+            {
+                Entry entry;
+                entry.id = dirEntry.path().filename().string();
+                entry.path = dirEntry.path();
+                if (entry.id.size() > PURGING_SUFFIX.size() && entry.id.compare(entry.id.size() - PURGING_SUFFIX.size(), PURGING_SUFFIX.size(), PURGING_SUFFIX) == 0)
+                {
+                    entry.id.resize(entry.id.size() - PURGING_SUFFIX.size());
+                    entry.purging = true;
+                }
+                else
+                {
+                    std::ifstream file(entry.path / "meta.json");
+                    entry.meta = nlohmann::json::parse(file, nullptr, false);
+                    if (entry.meta.is_discarded() || !entry.meta.is_object())
+                        entry.meta = nlohmann::json::object();
+                }
+                entries.push_back(entry);
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.id < b.id; });
+        return entries;
+    }
+
+    // Move a trashed project back to where it was deleted from.
+    inline bool Restore(const Entry &entry, std::string &error)
+    {
+        fs::path original = entry.meta.value("path", "");
+        if (entry.purging || original.empty())
+        {
+            error = "Trash entry '" + entry.id + "' is already being purged.";
+            return false;
+        }
+        if (fs::exists(original))
+        {
+            error = "Cannot restore, '" + original.string() + "' exists again.";
+            return false;
+        }
+        std::error_code ec;
+        fs::create_directories(original.parent_path(), ec);
+        if (rename((entry.path / "project").c_str(), original.c_str()) != 0)
+        {
+            error = errno == ENOENT ? "Trash entry '" + entry.id + "' is already being purged." : std::string(std::strerror(errno));
+            return false;
+        }
+        fs::remove_all(entry.path, ec);
+        return true;
+    }
+
+    // Claim an entry for purging. Fails if an undo or another worker got to it first.
+    inline bool Claim(Entry &entry)
+    {
+        if (entry.purging)
+            return true;
+        fs::path claimed = entry.path.string() + PURGING_SUFFIX;
+        if (rename(entry.path.c_str(), claimed.c_str()) != 0)
+            return false;
+        entry.path = claimed;
+        entry.purging = true;
+        return true;
+    }
+
+    // Unlink a claimed entry. The tree is split into its top two levels and those subtrees are
+    // removed on all cores, what is left afterwards is only empty directories.
+    inline void Purge(const Entry &entry)
+    {
+        std::vector<fs::path> subtrees;
+        std::error_code ec;
+        for (const auto &child : fs::directory_iterator(entry.path / "project", ec))
+        {
+            if (child.is_directory(ec) && !child.is_symlink(ec))
+            {
+                for (const auto &grandchild : fs::directory_iterator(child.path(), ec))
+                    subtrees.push_back(grandchild.path());
+            }
+            else
+            {
+                subtrees.push_back(child.path());
+            }
+        }
+        Parallel::ForEach(subtrees.size(), Parallel::HardwareThreads(), [&](size_t i) {
+            FsUtil::RemoveTree(subtrees[i]);
+        });
+        FsUtil::RemoveTree(entry.path);
+    }
+
+    // Purge every entry whose grace period is over, or all of them with `force`.
+    // Entries left half-purged by a worker that died are only picked up with `force`,
+    // a running worker may still own them. Returns the number of entries purged.
+    inline size_t PurgeDue(const std::vector<fs::path> &roots, bool force = false)
+    {
+        time_t now = std::time(nullptr);
+        size_t purged = 0;
+        for (Entry &entry : List(roots))
+        {
+            if (entry.purging ? !force : (!force && PurgeAt(entry) > now))
+                continue;
+            if (!Claim(entry))
+                continue;
+            Purge(entry);
+            purged++;
+        }
+        return purged;
+    }
+
+    // Set by hosts that embed devcore (DevCore.hpp). Forking a multi-threaded host is unsafe, the
+    // child could block on a lock another thread held and would keep the host's fds open, so the
+    // purger runs as a detached thread of the host instead.
+    inline bool purgeInProcess = false;
+
+    // Purge the trash as grace periods run out, return once nothing is pending.
+    inline void PurgeUntilEmpty(const std::vector<fs::path> &roots)
+    {
+        while (true)
+        {
+            PurgeDue(roots);
+            time_t next = 0;
+            for (const Entry &entry : List(roots))
+            {
+                if (!entry.purging && (next == 0 || PurgeAt(entry) < next))
+                    next = PurgeAt(entry);
+            }
+            if (next == 0)
+                break;
+            time_t now = std::time(nullptr);
+            sleep(static_cast<unsigned int>(std::max<time_t>(1, next - now)));
+        }
+    }
+
+    // Start a detached worker that purges the trash as grace periods run out and exits once
+    // nothing is pending. It is double-forked into its own session, so it outlives the command
+    // and the terminal, and never becomes a zombie of the calling process.
+    // Purgers started side by side are safe, every entry is claimed before it is purged.
+    inline void SpawnPurger(const std::vector<fs::path> &roots)
+    {
+        if (purgeInProcess)
+        {
+            std::thread(PurgeUntilEmpty, roots).detach();
+            return;
+        }
+
+        pid_t child = fork();
+        if (child < 0)
+            return;
+        if (child > 0)
+        {
+            waitpid(child, nullptr, 0);
+            return;
+        }
+
+        setsid();
+        if (fork() != 0)
+            _exit(0);
+        if (chdir("/") != 0)
+            _exit(1);
+        int devNull = open("/dev/null", O_RDWR);
+        if (devNull >= 0)
+        {
+            dup2(devNull, STDIN_FILENO);
+            dup2(devNull, STDOUT_FILENO);
+            dup2(devNull, STDERR_FILENO);
+            close(devNull);
+        }
+        PurgeUntilEmpty(roots);
+        _exit(0);
+    }
+} // namespace Trash
+
+#endif // TRASH_HPP
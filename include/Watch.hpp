@@ -0,0 +1,236 @@
+#ifndef WATCH_HPP
+#define WATCH_HPP
+
+#include "Scanner.hpp"
+#include "Artifacts.hpp"
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+// File change notifications for `devcore watch`.
+// inotify does not watch trees, so every directory of a project gets its own watch and new
+// directories are added as they appear. The top-level .git folder is watched on its own (commits
+// and staging change the index there) but not below it, and neither are scanner excludes and
+// build artifacts, which change all the time without saying anything about the project.
+// Projects roots and their language folders are watched for projects coming and going.
+namespace Watch
+{
+    const uint32_t PROJECT_EVENTS = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR;
+    const uint32_t LAYOUT_EVENTS = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR;
+
+    class Watcher
+    {
+    public:
+        bool Open(std::string &error)
+        {
+            exhausted = false;
+            fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (fd < 0)
+                error = "inotify: " + std::string(std::strerror(errno));
+            return fd >= 0;
+        }
+
+        void Close()
+        {
+            if (fd >= 0)
+                close(fd);
+            fd = -1;
+            targets.clear();
+        }
+
+        int Fd() const { return fd; }
+        size_t Count() const { return targets.size(); }
+        // Set once the kernel refused a watch (fs.inotify.max_user_watches), changes in some
+        // directories then go unnoticed.
+        bool Exhausted() const { return exhausted; }
+
+        // A projects root or language folder, where projects are created and removed.
+        void AddLayout(const fs::path &dir)
+        {
+            Add(dir, LAYOUT_EVENTS, {-1, "", "", false, ""});
+        }
+
+        // Every directory of a project.
+        void AddProject(long project, const fs::path &path, const std::string &lang)
+        {
+            AddTree(project, path.string(), "", lang);
+        }
+
+        // Read the pending events. Projects with changes are added to `changed`, `layout` is set
+        // when a project or language folder appeared or disappeared. Returns false if events were
+        // lost (queue overflow), then every project has to be treated as changed.
+        bool Read(std::set<long> &changed, bool &layout)
+        {
+            alignas(inotify_event) char buffer[64 * 1024];
+            bool complete = true;
+            while (true)
+            {
+                ssize_t length = read(fd, buffer, sizeof(buffer));
+                if (length <= 0)
+                    break;
+                for (char *p = buffer; p < buffer + length;)
+                {
+                    const inotify_event *event = reinterpret_cast<const inotify_event *>(p);
+                    p += sizeof(inotify_event) + event->len;
+                    if (event->mask & IN_Q_OVERFLOW)
+                    {
+                        complete = false;
+                        continue;
+                    }
+                    auto found = targets.find(event->wd);
+                    if (found == targets.end())
+                        continue;
+                    if (event->mask & IN_IGNORED)
+                    {
+                        targets.erase(found);
+                        continue;
+                    }
+                    Target target = found->second;
+                    if (target.project < 0)
+                    {
+                        if (event->mask & (IN_ISDIR | IN_DELETE_SELF))
+                            layout = true;
+                        continue;
+                    }
+                    changed.insert(target.project);
+                    // A new directory inside the project is watched too (not inside .git).
+                    if (!target.git && (event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)) && event->len > 0)
+                    {
+                        std::string rel = target.rel.empty() ? std::string(event->name) : target.rel + "/" + event->name;
+                        AddTree(target.project, target.root, rel, target.lang);
+                    }
+                }
+            }
+            return complete;
+        }
+
+        ~Watcher() { Close(); }
+
+    private:
+        struct Target
+        {
+            long project;     // -1 for layout folders.
+            std::string root; // Project directory.
+            std::string rel;  // Directory relative to the project.
+            bool git;         // The project's .git folder.
+            std::string lang;
+        };
+
+        void Add(const fs::path &dir, uint32_t mask, Target target)
+        {
+            if (exhausted)
+                return;
+            int wd = inotify_add_watch(fd, dir.c_str(), mask);
+            if (wd < 0)
+            {
+                if (errno == ENOSPC)
+                    exhausted = true;
+                return;
+            }
+            targets[wd] = std::move(target);
+        }
+
+        void AddTree(long project, const std::string &root, const std::string &start, const std::string &lang)
+        {
+            std::vector<std::string> rule = Artifacts::RulesFor(lang, root);
+            std::vector<std::string> stack{start};
+            while (!stack.empty() && !exhausted)
+            {
+                std::string rel = std::move(stack.back());
+                stack.pop_back();
+                std::string dir = rel.empty() ? root : root + "/" + rel;
+                Add(dir, PROJECT_EVENTS, {project, root, rel, false, lang});
+
+                DIR *handle = opendir(dir.c_str());
+                if (!handle)
+                    continue;
+                while (struct dirent *entry = readdir(handle))
+                {
+                    const char *name = entry->d_name;
+                    if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                        continue;
+                    struct stat st;
+                    if (fstatat(dirfd(handle), name, &st, AT_SYMLINK_NOFOLLOW) != 0 || !S_ISDIR(st.st_mode))
+                        continue;
+                    std::string childRel = rel.empty() ? std::string(name) : rel + "/" + name;
+                    if (rel.empty() && std::strcmp(name, ".git") == 0)
+                    {
+                        Add(dir + "/.git", IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_ONLYDIR, {project, root, childRel, true, lang});
+                        continue;
+                    }
+                    if (Scanner::IsExcluded(childRel, name))
+                        continue;
+                    if (Artifacts::Matches(rule, name, st.st_mode, rel.empty()))
+                        continue;
+                    stack.push_back(childRel);
+                }
+                closedir(handle);
+            }
+        }
+
+        int fd = -1;
+        bool exhausted = false;
+        std::unordered_map<int, Target> targets;
+    };
+
+    // Signals reach the event loop through a pipe: 'w' for a resized terminal, 'q' to quit.
+    inline int signalPipe[2] = {-1, -1};
+
+    inline void OnSignal(int signal)
+    {
+        int saved = errno;
+        char c = signal == SIGWINCH ? 'w' : 'q';
+        if (write(signalPipe[1], &c, 1) < 0)
+        {
+            // The pipe is full, the loop wakes up anyway.
+        }
+        errno = saved;
+    }
+
+    inline bool CatchSignals()
+    {
+        if (signalPipe[0] < 0 && pipe2(signalPipe, O_NONBLOCK | O_CLOEXEC) != 0)
+            return false;
+        struct sigaction action{};
+        action.sa_handler = OnSignal;
+        sigemptyset(&action.sa_mask);
+        for (int signal : {SIGWINCH, SIGINT, SIGTERM, SIGHUP})
+            sigaction(signal, &action, nullptr);
+        return true;
+    }
+
+    // Back to the default handlers, for a process that goes on after its loop.
+    inline void ReleaseSignals()
+    {
+        for (int signal : {SIGWINCH, SIGINT, SIGTERM, SIGHUP})
+            std::signal(signal, SIG_DFL);
+    }
+
+    // Whether a git worktree has uncommitted changes. --no-optional-locks keeps git status from
+    // refreshing the index, which would otherwise show up as a change in .git.
+    inline bool GitDirty(const std::string &quotedPath)
+    {
+        std::string command = "git -C " + quotedPath + " --no-optional-locks status --porcelain --untracked-files=normal 2>/dev/null";
+        FILE *pipe = popen(command.c_str(), "r");
+        if (!pipe)
+            return false;
+        char buffer[256];
+        bool dirty = false;
+        while (fgets(buffer, sizeof(buffer), pipe))
+            dirty = true;
+        pclose(pipe);
+        return dirty;
+    }
+} // namespace Watch
+
+#endif // WATCH_HPP
@@ -70,6 +70,11 @@ if [[ "$continueInstall" =~ ^[Yy] ]]; then
     [ -f devcore.conf ] && cp devcore.conf "$HOME/.config/devcore/devcore.conf" || echo -e "${YELLOW}⚠️  Warning: devcore.conf not found.${RESET}"
     [ -f devmap.json ] && cp devmap.json "$HOME/.config/devcore/devmap.json" || echo -e "${YELLOW}⚠️  Warning: devmap.json not found.${RESET}"
 
+    echo -e "${GREEN}⌨️  Installing shell completions...${RESET}"
+    mkdir -p "$HOME/.config/devcore/completions"
+    cp completions/* "$HOME/.config/devcore/completions/"
+    echo -e "${YELLOW}💡 Enable them with: ${WHITE}source ~/.config/devcore/completions/devcore.bash${YELLOW} (or the .zsh/.fish variant).${RESET}"
+
     echo -e "${CYAN}------------------------------------------${RESET}"
     echo -e "${GREEN}📂 Ensuring the projects directory exists...${RESET}"
     mkdir -p "$HOME/Coding/Projects"
@@ -1 +1 @@
-g++ source/*.cpp -o devcore
+g++ source/*.cpp -o devcore -pthread
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include "../dependencies/Config.hpp"
 #include "../include/DevMap.hpp"
 #include "../include/Main.hpp"
+#include "../include/Complete.hpp"
+#include "../include/Batch.hpp"
+#include "../include/Picker.hpp"
+#include "../include/Jump.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,17 +26,40 @@ void PrintHelp() {
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore devmap view                             " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - View current devmap\n\n" +
 
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore create-project                          " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Create a new project\n" +
-        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore delete-project                          " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Delete an existing project\n\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore create-project --manifest <file>        " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Create many projects from a JSON manifest\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore create-project --name <n> --lang <l>    " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Create a project without prompts\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "    [--folder <f>] [--template <t>] [--git]      " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + "\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore delete-project                          " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Delete an existing project (moved to the trash)\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore trash                                   " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Show deleted projects that are not purged yet\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore trash undo <id|name>                    " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Restore a deleted project\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore trash purge                             " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Permanently delete everything in the trash\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore archive <project>                       " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Pack an inactive project into a .tar.zst archive\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore restore <project>                       " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Unpack an archived project\n\n" +
+
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore open [<project>]                        " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Open a project in the editor, picked as you type\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore jump [<fragment>...]                    " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Path of the best matching, most visited project\n\n" +
 
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore create-lang <lang>                      " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Create a new language\n" +
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore delete-lang <lang>                      " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Delete a language (if empty)\n\n" +
 
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore list [projects|users|languages]         " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - List items\n" +
-        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore list-all projects                       " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - List all projects with details\n\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore list projects --recent <n>              " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - The n most recently active projects\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore list projects --stale <days>            " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Projects untouched for at least <days> days\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore list-all projects                       " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - List all projects with details\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore watch                                   " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Live view of every project that updates on change\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore du [-n <count>] [--lang <lang>]         " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Disk usage per language and largest projects\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore clean [--lang <lang>] [--dry-run]       " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Remove build artifacts from projects\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore dedupe [--dry-run] [--hardlink]         " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Share identical files across projects and templates\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore similar [--threshold <percent>]         " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Find projects that are copies of each other\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore build [--lang <lang>] [-j <n>] [--force]" + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Build changed projects with a shared job limit\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore deps [--project <name>] [--rdeps <file>]" + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - C/C++ include graph (--format dot|json)\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore stats [--project <name>] [--lang <lang>]" + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Files and lines per project, language and type\n\n" +
 
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore add-template                            " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Add a new template\n" +
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore remove-template                         " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Remove an existing template\n\n" +
 
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore batch [file] [-v] [-e]                  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Run commands from a file or stdin in one process\n\n" +
+
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore github                                  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Open the GitHub repository\n" +
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore update                                  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Update DevCore (wiht build)\n" +
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore --help                                  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Display this help menu";
@@ -149,6 +176,17 @@ int HandleList(int argc, char const *argv[])
         else
             Canvas::PrintCommandError(argc, argv);
     }
+    else if ((command == "list" || command == "-l") && argc == 5 && (param1 == "projects" || param1 == "-p"))
+    {
+        std::string option = argv[3];
+        long value = std::strtol(argv[4], nullptr, 10);
+        if (option == "--recent" && value > 0)
+            DevMap::ListRecentProjects(static_cast<size_t>(value));
+        else if (option == "--stale" && value >= 0)
+            DevMap::ListStaleProjects(value);
+        else
+            Canvas::PrintCommandError(argc, argv);
+    }
     else if ((command == "list-all" || command == "-la") && argc == 3)
     {
         if (param1 == "projects" || param1 == "-p")
@@ -164,17 +202,246 @@ int HandleList(int argc, char const *argv[])
     return 0;
 }
 
-int HandleCreateProject(int argc, char const *argv[])
+int HandleDiskUsage(int argc, char const *argv[])
 {
-    if (argc != 2)
+    size_t topN = 10;
+    std::string lang;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if ((arg == "-n" || arg == "--top") && i + 1 < argc)
+            topN = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--lang" && i + 1 < argc)
+            lang = argv[++i];
+        else
+        {
+            Canvas::PrintCommandError(argc, argv);
+            return 1;
+        }
+    }
+
+    DevMap::ListDiskUsage(topN, lang);
+
+    return 0;
+}
+
+int HandleClean(int argc, char const *argv[])
+{
+    std::string lang;
+    bool dryRun = false;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--lang" && i + 1 < argc)
+            lang = argv[++i];
+        else if (arg == "--dry-run" || arg == "-n")
+            dryRun = true;
+        else
+        {
+            Canvas::PrintCommandError(argc, argv);
+            return 1;
+        }
+    }
+
+    DevMap::CleanProjects(lang, dryRun);
+
+    return 0;
+}
+
+int HandleDedupe(int argc, char const *argv[])
+{
+    bool dryRun = false;
+    bool hardlink = false;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--dry-run" || arg == "-n")
+            dryRun = true;
+        else if (arg == "--hardlink")
+            hardlink = true;
+        else
+        {
+            Canvas::PrintCommandError(argc, argv);
+            return 1;
+        }
+    }
+
+    DevMap::DedupeProjects(dryRun, hardlink);
+
+    return 0;
+}
+
+int HandleSimilar(int argc, char const *argv[])
+{
+    double threshold = 0.6;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        // Accepted as a fraction (0.8) or a percentage (80).
+        double value = i + 1 < argc ? std::atof(argv[i + 1]) : 0;
+        if (arg == "--threshold" && value > 0 && value <= 100)
+        {
+            threshold = value > 1 ? value / 100 : value;
+            i++;
+        }
+        else
+        {
+            Canvas::PrintCommandError(argc, argv);
+            return 1;
+        }
+    }
+
+    DevMap::FindSimilarProjects(threshold);
+
+    return 0;
+}
+
+int HandleBuild(int argc, char const *argv[])
+{
+    std::string lang;
+    size_t jobs = 0;
+    bool force = false;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--lang" && i + 1 < argc)
+            lang = argv[++i];
+        else if (arg == "-j" && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+            jobs = std::atoi(argv[++i]);
+        else if (arg == "--force" || arg == "-B")
+            force = true;
+        else
+        {
+            Canvas::PrintCommandError(argc, argv);
+            return 1;
+        }
+    }
+
+    return DevMap::BuildProjects(lang, jobs, force) ? 0 : 1;
+}
+
+int HandleDeps(int argc, char const *argv[])
+{
+    std::string project, lang, format, rdeps;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--project" && hasValue)
+            project = argv[++i];
+        else if (arg == "--lang" && hasValue)
+            lang = argv[++i];
+        else if (arg == "--format" && hasValue && (std::string(argv[i + 1]) == "dot" || std::string(argv[i + 1]) == "json"))
+            format = argv[++i];
+        else if (arg == "--rdeps" && hasValue)
+            rdeps = argv[++i];
+        else
+        {
+            Canvas::PrintCommandError(argc, argv);
+            return 1;
+        }
+    }
+
+    return DevMap::PrintDeps(project, lang, format, rdeps) ? 0 : 1;
+}
+
+int HandleStats(int argc, char const *argv[])
+{
+    std::string project, lang;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--project" && i + 1 < argc)
+            project = argv[++i];
+        else if (arg == "--lang" && i + 1 < argc)
+            lang = argv[++i];
+        else
+        {
+            Canvas::PrintCommandError(argc, argv);
+            return 1;
+        }
+    }
+
+    return DevMap::ProjectStats(project, lang) ? 0 : 1;
+}
+
+// devcore open [<project>]
+// Without a name, or with one that is not a project, the project is picked interactively.
+int HandleOpen(int argc, char const *argv[])
+{
+    if (argc > 3)
     {
         Canvas::PrintCommandError(argc, argv);
+        return 1;
+    }
+
+    std::string projectName = argc == 3 ? argv[2] : "";
+    if (!projectName.empty() && DevMap::findProjectByName(DevMap::projects, projectName) == nullptr)
+        DevMap::syncDevMap();
+    if (DevMap::findProjectByName(DevMap::projects, projectName) == nullptr && Picker::Interactive())
+    {
+        std::vector<std::string> names;
+        for (const auto &proj : DevMap::projects)
+            names.push_back(proj.name);
+        std::sort(names.begin(), names.end());
+        if (!Picker::Pick(" Open project ", names, projectName, projectName))
+            return 1;
+    }
+    else if (projectName.empty())
+    {
+        DevMap::ListProjects();
+        projectName = Canvas::GetStringInput("👉 What project do you want to open? ");
+    }
+
+    return DevMap::OpenProject(projectName) ? 0 : 1;
+}
+
+int HandleCreateProject(int argc, char const *argv[])
+{
+    if (argc == 2)
+    {
+        DevMap::CreateProjectWizard();
         return 0;
     }
 
-    DevMap::CreateProjectWizard();
+    // Non-interactive: either a manifest or a single project described by flags.
+    std::string manifest;
+    DevMap::ProjectSpec spec;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--manifest" && hasValue)
+            manifest = argv[++i];
+        else if (arg == "--name" && hasValue)
+            spec.name = argv[++i];
+        else if (arg == "--lang" && hasValue)
+            spec.lang = argv[++i];
+        else if (arg == "--folder" && hasValue)
+            spec.folderName = argv[++i];
+        else if (arg == "--template" && hasValue)
+            spec.templateName = argv[++i];
+        else if (arg == "--git")
+            spec.git = true;
+        else
+        {
+            Canvas::PrintCommandError(argc, argv);
+            return 1;
+        }
+    }
+
+    std::vector<DevMap::ProjectSpec> specs;
+    if (!manifest.empty())
+    {
+        if (!DevMap::LoadManifest(manifest, specs))
+            return 1;
+    }
+    else
+    {
+        specs.push_back(spec);
+    }
 
-    return 0;
+    return DevMap::CreateProjects(specs) ? 0 : 1;
 }
 
 int HandleDeleteProject(int argc, char const *argv[])
@@ -190,6 +457,37 @@ int HandleDeleteProject(int argc, char const *argv[])
     return 0;
 }
 
+int HandleTrash(int argc, char const *argv[])
+{
+    if (argc == 2)
+        DevMap::ListTrash();
+    else if (argc == 4 && std::string(argv[2]) == "undo")
+        return DevMap::UndoTrash(argv[3]) ? 0 : 1;
+    else if (argc == 3 && std::string(argv[2]) == "purge")
+        DevMap::PurgeTrash();
+    else
+    {
+        Canvas::PrintCommandError(argc, argv);
+        return 1;
+    }
+
+    return 0;
+}
+
+int HandleArchive(int argc, char const *argv[])
+{
+    if (argc != 3)
+    {
+        Canvas::PrintCommandError(argc, argv);
+        return 1;
+    }
+
+    std::string command = argv[1];
+    bool ok = command == "archive" ? DevMap::ArchiveProject(argv[2]) : DevMap::RestoreProject(argv[2]);
+
+    return ok ? 0 : 1;
+}
+
 int HandleCreateLang(int argc, char const *argv[])
 {
     if (argc != 3)
@@ -228,7 +526,7 @@ int HandleAddTemplate(int argc, char const *argv[])
         return 0;
     }
 
-    DevMap::AddTemplate();
+    DevMap::AddTemplateWizard();
 
     return 0;
 }
@@ -241,26 +539,172 @@ int HandleRemoveTemplate(int argc, char const *argv[])
         return 0;
     }
 
-    DevMap::RemoveTemplate();
+    DevMap::RemoveTemplateWizard();
 
     return 0;
 }
 
+int RunCommand(int argc, char const *argv[]);
+
+// Run newline separated commands from a file or stdin against a single load of the config and
+// the DevMap. The commands run embedded, so they never prompt or exit, and their DevMap changes
+// are written once at the end. One result line is printed per command:
+//     ok<TAB><line number><TAB><command>
+//     error<TAB><line number><TAB><command><TAB><message>
+int HandleBatch(int argc, char const *argv[])
+{
+    std::string source = "-";
+    bool verbose = false;
+    bool stopOnError = false;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--verbose" || arg == "-v")
+            verbose = true;
+        else if (arg == "--stop-on-error" || arg == "-e")
+            stopOnError = true;
+        else if (source == "-" && (arg == "-" || arg[0] != '-'))
+            source = arg;
+        else
+        {
+            Canvas::PrintCommandError(argc, argv);
+            return 1;
+        }
+    }
+
+    std::ifstream file;
+    std::istream *input = &std::cin;
+    if (source != "-")
+    {
+        file.open(source);
+        if (!file.is_open())
+        {
+            Canvas::PrintError("Unable to open batch file: " + source);
+            return 1;
+        }
+        input = &file;
+    }
+
+    Canvas::embedded = true;
+    Canvas::silent = !verbose;
+    DevMap::deferCommits = true;
+
+    size_t failed = 0;
+    std::string line;
+    for (size_t number = 1; std::getline(*input, line); number++)
+    {
+        std::vector<std::string> words;
+        std::string error;
+        bool parsed = Batch::Split(line, words, error);
+        if (parsed && words.empty())
+            continue;
+
+        Canvas::errors.clear();
+        int status = 1;
+        std::string commandLine;
+        for (const auto &word : words)
+        {
+            bool plain = !word.empty() && word.find_first_of(" \t'\"\\#") == std::string::npos;
+            commandLine += (commandLine.empty() ? "" : " ") + (plain ? word : DevMap::ShellQuote(word));
+        }
+        if (!parsed)
+        {
+            Canvas::errors.push_back(error);
+            commandLine = line;
+        }
+        else if (words[0] == "batch" || words[0] == "update" || words[0] == "__complete")
+        {
+            Canvas::errors.push_back("'" + words[0] + "' cannot run inside a batch.");
+        }
+        else
+        {
+            std::vector<const char *> args{argv[0]};
+            for (const auto &word : words)
+                args.push_back(word.c_str());
+            try
+            {
+                status = RunCommand(static_cast<int>(args.size()), args.data());
+            }
+            catch (const std::exception &e)
+            {
+                if (Canvas::errors.empty())
+                    Canvas::errors.push_back(e.what());
+            }
+        }
+
+        bool ok = status == 0 && Canvas::errors.empty();
+        std::cout << (ok ? "ok" : "error") << '\t' << number << '\t' << commandLine;
+        if (!ok)
+        {
+            std::string message;
+            for (const auto &e : Canvas::errors)
+                message += (message.empty() ? "" : "; ") + e;
+            std::replace(message.begin(), message.end(), '\n', ' ');
+            std::cout << '\t' << (message.empty() ? "exit status " + std::to_string(status) : message);
+        }
+        std::cout << std::endl;
+
+        if (!ok)
+        {
+            failed++;
+            if (stopOnError)
+                break;
+        }
+    }
+
+    Canvas::embedded = false;
+    Canvas::silent = false;
+    Canvas::errors.clear();
+    if (!DevMap::Flush())
+        return 1;
+    return failed == 0 ? 0 : 1;
+}
+
 int main(int argc, char const *argv[]) {
+    // Shell completion runs on every keystroke, so it skips loading the config and syncing the DevMap.
+    if (argc >= 2 && std::string(argv[1]) == "__complete")
+        return Complete::Run(argc, argv);
+    // So does jumping to a project, the shell runs it on every directory change.
+    if (argc >= 2 && std::string(argv[1]) == "jump")
+        return Jump::Run(argc, argv);
+
     if (!Config::load(Main::HOME_PATH + Main::CONFIG_PATH))
         Config::setup(Main::HOME_PATH + Main::CONFIG_PATH);
 
-    if (!DevMap::load(Main::HOME_PATH + Main::DEVMAP_PATH))
+    // Commands that answer from the cached scan data skip the filesystem sync.
+    std::string command = argc >= 2 ? argv[1] : "";
+    bool activityQuery = (command == "list" || command == "-l") && argc == 5;
+    bool sync = command != "du" && command != "clean" && command != "dedupe" && command != "similar" && command != "build" && command != "deps" && command != "stats" && command != "trash" && command != "archive" && command != "restore" && command != "open" && !activityQuery;
+
+    // `devcore open` shows its picker straight from the name index, before the DevMap is read.
+    std::string picked;
+    if (command == "open" && argc == 2 && Picker::Interactive())
+    {
+        std::string buffer;
+        std::vector<std::string_view> index = Complete::ReadIndex('p', buffer);
+        if (!index.empty() && !Picker::Pick(" Open project ", std::vector<std::string>(index.begin(), index.end()), "", picked))
+            return 1;
+    }
+
+    if (!DevMap::load(Main::HOME_PATH + Main::DEVMAP_PATH, false, sync))
         DevMap::setup(Main::HOME_PATH + Main::DEVMAP_PATH);
 
+    if (!picked.empty())
+        return DevMap::OpenProject(picked) ? 0 : 1;
+
     if (argc < 2)
     {
         Canvas::PrintCommandError(argc, argv);
         return 1;
     }
 
-    std::string command = argv[1];
+    return RunCommand(argc, argv);
+}
 
+// Run one command against the loaded config and DevMap.
+int RunCommand(int argc, char const *argv[])
+{
+    std::string command = argv[1];
 
     if (command == "config")
     {
@@ -274,6 +718,43 @@ int main(int argc, char const *argv[]) {
     {
         return HandleList(argc, argv);
     }
+    else if (command == "du")
+    {
+        return HandleDiskUsage(argc, argv);
+    }
+    else if (command == "clean")
+    {
+        return HandleClean(argc, argv);
+    }
+    else if (command == "dedupe")
+    {
+        return HandleDedupe(argc, argv);
+    }
+    else if (command == "watch" && argc == 2)
+    {
+        DevMap::WatchProjects();
+        return 0;
+    }
+    else if (command == "similar")
+    {
+        return HandleSimilar(argc, argv);
+    }
+    else if (command == "build")
+    {
+        return HandleBuild(argc, argv);
+    }
+    else if (command == "deps")
+    {
+        return HandleDeps(argc, argv);
+    }
+    else if (command == "stats")
+    {
+        return HandleStats(argc, argv);
+    }
+    else if (command == "batch")
+    {
+        return HandleBatch(argc, argv);
+    }
     else if (command == "create-project")
     {
         return HandleCreateProject(argc, argv);
@@ -282,6 +763,14 @@ int main(int argc, char const *argv[]) {
     {
         return HandleDeleteProject(argc, argv);
     }
+    else if (command == "trash")
+    {
+        return HandleTrash(argc, argv);
+    }
+    else if (command == "archive" || command == "restore")
+    {
+        return HandleArchive(argc, argv);
+    }
     else if (command == "create-lang")
     {
         return HandleCreateLang(argc, argv);
@@ -371,20 +860,9 @@ int main(int argc, char const *argv[]) {
         Canvas::PrintInfo("Update complete.");
         return 0;
     }
-    else if (argc == 2 && command == "open")
+    else if (command == "open")
     {
-        DevMap::ListProjects();
-
-        std::string projectName = Canvas::GetStringInput("👉 What project do you want to open? ");
-
-        const DevMap::Project *project = DevMap::findProjectByName(DevMap::projects, projectName);
-        std::string editor = Config::get("editor");
-        std::string openCodeCmd = editor + " " + std::string(DevMap::projectsPath / project->lang / project->folderName);
-        if (std::system(openCodeCmd.c_str()) != 0)
-        {
-            Canvas::PrintError(u8"❌ Failed to open the project in Visual Studio Code, make sure its installed and added to your PATH.");
-        }
-
+        return HandleOpen(argc, argv);
     }
 
 